@@ -1 +1,275 @@
-// Obsoleted with switch to MAXMOD sound library
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+#include <maxmod7.h>
+#include <string.h>
+
+#include "emusoundfifo.h"
+#include "../../arm9/source/sound7.h"
+#include "../../arm9/source/cpu/ay38910/AY38910.h"
+
+// --------------------------------------------------------------------------------------------
+// The ARM7 end of the SOUND CPU option. The ARM9 posts what the Z80 did to the AY and the
+// beeper into a ring in main RAM (see sound7.h) and we turn it into samples here - in the
+// same batches and with the same AY write log replay as sound.c does when the ARM9 mixes.
+// The ARM9 makes its samples as left/right pairs for the maxmod stream (OurSoundMixer plays
+// two for every frame) so we average each pair into one sample of a buffer which one hardware
+// channel plays on a loop at the pair rate. TIMER2 runs at that rate off the same clock as the
+// channel and TIMER3 counts its overflows so we always know how far the channel has played
+// and can keep OUT_LEAD samples ahead of it.
+// --------------------------------------------------------------------------------------------
+#define OUT_CHANNEL     15      // Locked away from maxmod while we have it
+#define OUT_SAMPLES     2048    // Must be a power of 2 (and divide the 16-bit TIMER3 count)
+#define OUT_LEAD        1024    // As far as we run ahead of the channel
+#define OUT_LOW         512     // Less than this and nothing to make - hold the last sample
+#define OUT_BACKLOG     512     // More than this left in the ring and we are playing too slowly
+
+#define AUDIO_BATCH     64      // Samples made before the AY runs and the batch is mixed
+#define AY_LOG          256
+
+typedef struct
+{
+    u8 sample;                  // Which sample of the batch the write takes effect on
+    u8 data;                    // 0 for a write to the register index, 1 for the register itself
+    u8 value;
+    u8 unused;
+} AYWrite_t;
+
+static SoundShare_t *share = NULL;
+static u32 out_rate = 0;
+static u16 out_write = 0;
+static s16 out_last = 0;
+static s32 out_first = 0;       // First sample of the pair being made
+static u8  out_odd = 0;         // Set when we have it
+static u8  out_ahead = 0;       // The ARM9 is getting ahead of the channel - leave samples out
+static s16 out_buf[OUT_SAMPLES] ALIGN(4);
+
+static AY38910 ay7;
+static u8  ay_enabled = 0;
+static u8  ay_low = 0;       // LOW sound quality - two chip ticks for each pass of the AY mixer
+static AYWrite_t ay_log[AY_LOG];
+static u16 ay_log_len = 0;
+static u8  ay_pos = 0;
+static u8  audio_len = 0;
+static s16 audio_ay[AUDIO_BATCH];
+static s16 audio_beeper[AUDIO_BATCH];
+
+static u8  beeper_pos = 0;
+static s32 beeper_level = 0;
+static s32 beeper_ring[BEEPER_RING];
+
+// The ARM9 sends where the ring is once - we start on it when it gives us a sample rate
+static void emuSoundAddressHandler(void *address, void *userdata)
+{
+    share = (SoundShare_t *)address;
+}
+
+void installEmuSoundFIFO(void)
+{
+    fifoSetAddressHandler(FIFO_USER_01, emuSoundAddressHandler, 0);
+}
+
+// Run the AY on to sample 'upto' of the batch
+static void ay_run(u8 upto)
+{
+    if (upto <= ay_pos) return;
+    if (ay_enabled)
+    {
+        if (ay_low) ay38910MixerLo(upto - ay_pos, &audio_ay[ay_pos], &ay7);
+        else ay38910Mixer(upto - ay_pos, &audio_ay[ay_pos], &ay7);
+    }
+    else memset(&audio_ay[ay_pos], 0x00, (upto - ay_pos) * sizeof(s16));
+    ay_pos = upto;
+}
+
+static void ay_replay(u8 upto)
+{
+    for (u16 i=0; i<ay_log_len; i++)
+    {
+        AYWrite_t *w = &ay_log[i];
+        ay_run((w->sample < upto) ? w->sample : upto);
+        if (w->data) ay38910DataW(w->value, &ay7);
+        else ay38910IndexW(w->value, &ay7);
+    }
+    ay_log_len = 0;
+    ay_run(upto);
+}
+
+// The batch is done - mix the AY and the beeper into the buffer the channel is playing
+static void audio_flush(void)
+{
+    ay_replay(audio_len);
+
+    // One sample a batch goes while the ARM9 is ahead - a lot less to hear than the ring filling
+    for (u8 i=(out_ahead ? 1:0); i<audio_len; i++)
+    {
+        s32 sample = audio_ay[i] + audio_beeper[i];
+        if (!out_odd)
+        {
+            out_first = sample;
+            out_odd = 1;
+            continue;
+        }
+        out_odd = 0;
+
+        if (!share->pause) out_last = (out_first + sample) >> 1;
+        out_buf[out_write & (OUT_SAMPLES-1)] = out_last;
+        out_write++;
+    }
+
+    audio_len = 0;
+    ay_pos = 0;
+}
+
+static void audio_reset(void)
+{
+    ay38910Reset(&ay7);
+    ay38910IndexW(0x07, &ay7);
+    ay38910DataW(0x3F, &ay7);
+    ay38910Mixer(4, audio_ay, &ay7);
+    memset(audio_ay, 0x00, sizeof(audio_ay));
+    ay_log_len = 0;
+    ay_pos = audio_len = 0;
+    out_odd = 0;
+}
+
+static void audio_command(u32 cmd)
+{
+    switch (cmd & SND7_CMD_MASK)
+    {
+        case SND7_SAMPLES:
+            for (u16 i=(cmd & 0xFFFF); i>0; i--)
+            {
+                beeper_level += beeper_ring[beeper_pos];
+                beeper_ring[beeper_pos] = 0;
+                beeper_pos = (beeper_pos + 1) & (BEEPER_RING-1);
+                audio_beeper[audio_len++] = beeper_level >> BEEPER_SHIFT;
+                if (audio_len >= AUDIO_BATCH) audio_flush();
+            }
+            break;
+
+        case SND7_AY:
+            if (ay_log_len == AY_LOG) ay_replay(audio_len);
+            ay_log[ay_log_len].sample = audio_len + ((cmd >> 8) & 1);
+            ay_log[ay_log_len].data   = (cmd >> 9) & 1;
+            ay_log[ay_log_len].value  = cmd & 0xFF;
+            ay_log_len++;
+            break;
+
+        case SND7_BEEPER:
+            {
+                s32 delta = (cmd & 0x400) ? BEEPER_VOLUME : -BEEPER_VOLUME;
+                const s16 *blep = beeper_blep[cmd & (BEEPER_PHASES-1)];
+                u8 idx = beeper_pos + ((cmd >> 5) & 0x1F) - 3;
+                for (u8 j=0; j<BEEPER_TAPS; j++)
+                {
+                    beeper_ring[(idx + j) & (BEEPER_RING-1)] += delta * blep[j];
+                }
+            }
+            break;
+
+        case SND7_SYNC:
+            memset(beeper_ring, 0x00, sizeof(beeper_ring));
+            beeper_level = (cmd & 1) ? (BEEPER_VOLUME << BEEPER_SHIFT) : 0;
+            break;
+
+        case SND7_FLUSH:
+            audio_flush();
+            break;
+
+        case SND7_AY_ENABLE:
+            ay_replay(audio_len);
+            ay_enabled = cmd & 1;
+            break;
+
+        case SND7_RESET:
+            audio_reset();
+            ay_low = cmd & 1;
+            break;
+    }
+}
+
+// The channel timer rounds up so we play very slightly slower than the ARM9 makes the pairs
+// and it is only ever the backlog check in emuSoundUpdate() that has to take up the slack
+static void out_start(u32 rate)
+{
+    u16 timer = -(((BUS_CLOCK >> 1) + rate - 1) / rate);
+
+    out_rate = rate;
+    memset(out_buf, 0x00, sizeof(out_buf));
+    out_last = 0;
+    out_ahead = 0;
+    audio_reset();
+
+    mmLockChannels(BIT(OUT_CHANNEL));
+    SCHANNEL_CR(OUT_CHANNEL) = 0;
+    TIMER_CR(2) = 0;
+    TIMER_CR(3) = 0;
+
+    SCHANNEL_SOURCE(OUT_CHANNEL) = (u32)out_buf;
+    SCHANNEL_REPEAT_POINT(OUT_CHANNEL) = 0;
+    SCHANNEL_LENGTH(OUT_CHANNEL) = sizeof(out_buf) >> 2;
+    SCHANNEL_TIMER(OUT_CHANNEL) = timer;
+
+    // The channel timer ticks at half the bus clock so TIMER2 counts twice as far
+    TIMER_DATA(2) = (u16)(timer * 2);
+    TIMER_DATA(3) = 0;
+    TIMER_CR(3) = TIMER_ENABLE | TIMER_CASCADE;
+    TIMER_CR(2) = TIMER_ENABLE | TIMER_DIV_1;
+    SCHANNEL_CR(OUT_CHANNEL) = SCHANNEL_ENABLE | SOUND_REPEAT | SOUND_FORMAT_16BIT | SOUND_VOL(127) | SOUND_PAN(64);
+
+    out_write = OUT_LOW;
+}
+
+static void out_stop(void)
+{
+    SCHANNEL_CR(OUT_CHANNEL) = 0;
+    TIMER_CR(2) = 0;
+    TIMER_CR(3) = 0;
+    mmUnlockChannels(BIT(OUT_CHANNEL));
+    out_rate = 0;
+}
+
+// ----------------------------------------------------------------------------------------
+// Called from the main loop twice a frame. Read the ring until we are OUT_LEAD samples
+// ahead of the channel. The channel plays a touch slower than the ARM9 makes samples so
+// what is left in the ring slowly grows - past OUT_BACKLOG we start leaving samples out
+// until it is back under. If we are short (the emulation is paused or slow) keep the
+// last sample going so the channel never loops back over old samples.
+// ----------------------------------------------------------------------------------------
+void emuSoundUpdate(void)
+{
+    u32 rate = share ? share->rate : 0;
+    if (rate != out_rate)
+    {
+        if (out_rate) out_stop();
+        if (rate) out_start(rate);
+    }
+    if (!out_rate) return;
+
+    u16 played = TIMER_DATA(3);
+    if ((s16)(out_write - played) < 0) out_write = played;     // The channel overtook us
+
+    u16 tail = share->tail;
+    while (((s16)(out_write - played) < OUT_LEAD) && (tail != share->head))
+    {
+        audio_command(share->ring[tail]);
+        tail = (tail + 1) & (SND7_RING-1);
+        share->tail = tail;
+    }
+    out_ahead = (((share->head - tail) & (SND7_RING-1)) > OUT_BACKLOG);
+
+    while ((s16)(out_write - played) < OUT_LOW)
+    {
+        out_buf[out_write & (OUT_SAMPLES-1)] = out_last;
+        out_write++;
+    }
+}
@@ -0,0 +1,17 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#ifndef _EMUSOUNDFIFO_H_
+#define _EMUSOUNDFIFO_H_
+
+extern void installEmuSoundFIFO(void);
+extern void emuSoundUpdate(void);
+
+#endif // _EMUSOUNDFIFO_H_
@@ -31,6 +31,8 @@
 #include <dswifi7.h>
 #include <maxmod7.h>
 
+#include "emusoundfifo.h"
+
 extern void mmInstall( int fifo_channel );
 
 //---------------------------------------------------------------------------------
@@ -73,6 +75,7 @@ int main() {
 
 	//installWifiFIFO();
 	installSoundFIFO();
+	installEmuSoundFIFO();
 
 	installSystemFIFO();
 
@@ -83,13 +86,15 @@ int main() {
 	
 	setPowerButtonCB(powerButtonCB);   
 
-	// Keep the ARM7 mostly idle
+	// Keep the ARM7 mostly idle - apart from the mixing when the ARM9 hands it over
 	while (!exitflag) {
 		if ( 0 == (REG_KEYINPUT & (KEY_SELECT | KEY_START | KEY_L | KEY_R))) {
 			exitflag = true;
 		}
-    
-		swiWaitForVBlank();
+
+		emuSoundUpdate();
+
+		swiIntrWait(1, IRQ_VBLANK | IRQ_VCOUNT);
 	}
 	return 0;
 }
@@ -23,6 +23,7 @@
 #include "SpeccySE.h"
 #include "highscore.h"
 #include "SpeccyUtils.h"
+#include "render.h"
 #include "speccy_kbd.h"
 #include "debug_ovl.h"
 #include "cassette.h"
@@ -87,8 +88,6 @@ u16 timingFrames    __attribute__((section(".dtcm"))) = 0;
 // ----------------------------------------------------------------------------------
 u8 bSpeccyBiosFound   = false;
 
-u8 soundEmuPause     __attribute__((section(".dtcm"))) = 1;       // Set to 1 to pause (mute) sound, 0 is sound unmuted (sound channels active)
-
 // -----------------------------------------------------------------------------------------------
 // This set of critical vars is what determines the machine type -
 // -----------------------------------------------------------------------------------------------
@@ -166,22 +165,6 @@ u16 keyCoresp[MAX_KEY_OPTIONS] __attribute__((section(".dtcm"))) = {
 
 static char tmp[64];    // For various sprintf() calls
 
-// ------------------------------------------------------------
-// Utility function to pause the sound...
-// ------------------------------------------------------------
-void SoundPause(void)
-{
-    soundEmuPause = 1;
-}
-
-// ------------------------------------------------------------
-// Utility function to un pause the sound...
-// ------------------------------------------------------------
-void SoundUnPause(void)
-{
-    soundEmuPause = 0;
-}
-
 // --------------------------------------------------------------------------------------------
 // MAXMOD streaming setup and handling...
 // We were using the normal ARM7 sound core but it sounded "scratchy" and so with the help
@@ -193,110 +176,55 @@ void SoundUnPause(void)
 mm_ds_system sys   __attribute__((section(".dtcm")));
 mm_stream myStream __attribute__((section(".dtcm")));
 
-#define WAVE_DIRECT_BUF_SIZE 4095
-u16 mixer_read      __attribute__((section(".dtcm"))) = 0;
-u16 mixer_write     __attribute__((section(".dtcm"))) = 0;
-s16 mixer[WAVE_DIRECT_BUF_SIZE+1];
-
+extern mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats format);   // In sound.c
 
 // The games normally run at the proper 100% speed, but user can override from 80% to 120%
 u16 GAME_SPEED_PAL[]  __attribute__((section(".dtcm"))) = {655, 596, 547, 728, 818 };
 
-// -------------------------------------------------------------------------------------------
-// maxmod will call this routine when the buffer is half-empty and requests that
-// we fill the sound buffer with more samples. They will request 'len' samples and
-// we will fill exactly that many. If the sound is paused, we fill with 'mute' samples.
-// -------------------------------------------------------------------------------------------
-s16 last_sample __attribute__((section(".dtcm"))) = 0;
-int breather    __attribute__((section(".dtcm"))) = 0;
-
-ITCM_CODE mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats format)
-{
-    if (soundEmuPause)  // If paused, just "mix" in mute sound chip... all channels are OFF
-    {
-        s16 *p = (s16*)dest;
-        for (int i=0; i<len; i++)
-        {
-           *p++ = last_sample;      // To prevent pops and clicks... just keep outputting the last sample
-           *p++ = last_sample;      // To prevent pops and clicks... just keep outputting the last sample
-        }
-    }
-    else
-    {
-        s16 *p = (s16*)dest;
-        for (int i=0; i<len*2; i++)
-        {
-            if (mixer_read == mixer_write) {*p++ = last_sample;}
-            else
-            {
-                last_sample = mixer[mixer_read];
-                *p++ = last_sample;
-                mixer_read = (mixer_read + 1) & WAVE_DIRECT_BUF_SIZE;
-            }
-        }
-        if (breather) {breather -= (len*2); if (breather < 0) breather = 0;}
-    }
-
-    return  len;
-}
-
-// --------------------------------------------------------------------------------------------
-// This is called when we want to sample the audio directly - we grab 2x AY samples and mix
-// them with the beeper tones. We do a little bit of edge smoothing on the audio  tones here
-// to make the direct beeper sound a bit less harsh - but this really needs to be properly
-// over-sampled and smoothed someday to make it really shine... good enough for now.
-// --------------------------------------------------------------------------------------------
-s16 mixbufAY[4]  __attribute__((section(".dtcm")));
-s16 beeper_vol[4] __attribute__((section(".dtcm"))) = { 0x000, 0x200, 0x600, 0xA00 };
-u32 vol __attribute__((section(".dtcm"))) = 0;
-ITCM_CODE void processDirectAudio(void)
-{
-    if (zx_AY_enabled)
-    {
-        ay38910Mixer(2, mixbufAY, &myAY);
-    }
-
-    for (u8 i=0; i<2; i++)
-    {
-        // Smooth edges of beeper slightly...
-        if (portFE & 0x10) {if (vol < 3) vol++;}
-        else {if (vol) vol--;}
-
-        if (breather) {return;}
-        s16 sample = mixbufAY[i];
-        if (beeper_vol[vol])
-        {
-            sample += beeper_vol[vol] + (8 - (int)(rand() & 0xF)); // Sample plus a bit of white noise to break up aliasing
-        }
-        mixer[mixer_write] = sample;
-        mixer_write++; mixer_write &= WAVE_DIRECT_BUF_SIZE;
-        if (((mixer_write+1)&WAVE_DIRECT_BUF_SIZE) == mixer_read) {breather = 2048;}
-    }
-}
-
 // -----------------------------------------------------------------------------------------------
 // The user can override the core emulation speed from 80% to 120% to make games play faster/slow 
-// than normal. We must adjust the MaxMode sample frequency to match or else we will not have the
-// proper number of samples in our sound buffer... this isn't perfect but it's reasonably good!
+// than normal. The stream keeps playing at the same rate and reads our sample ring faster or
+// slower to match (see OurSoundMixer) so there are always the proper number of samples in our
+// sound buffer. This is also where the SOUND CPU option takes effect - with the ARM7 doing the
+// mixing it plays the samples itself at a rate to match and the maxmod stream is closed.
 // -----------------------------------------------------------------------------------------------
 static u8 last_game_speed = 0;
+static u8 last_sound_cpu = 0;
+static u8 last_sound_low = 0;
+static u32 last_arm7_rate = 0;
 static u32 sample_rate_adjust[] = {100, 110, 120, 90, 80};
 void newStreamSampleRate(void)
 {
-    if (last_game_speed != myConfig.gameSpeed)
+    // LOW quality makes half the samples - the DS-Lite can't spare the time for the full rate
+    u8 low = (myGlobalConfig.soundQuality == 2) || ((myGlobalConfig.soundQuality == 0) && !isDSiMode());
+
+    // The ARM7 has nothing like the mixer rate control - it plays the left/right pairs (two a
+    // scanline, one at LOW) at the rate the frame timer (32728Hz) runs the emulation at
+    u32 arm7_rate = (32728 * (zx_128k_mode ? 311:312) * (2 >> low)) / GAME_SPEED_PAL[myConfig.gameSpeed];
+
+    mixer_set_speed(sample_rate_adjust[myConfig.gameSpeed]);
+    sound_set_quality(low);
+
+    if ((last_game_speed != myConfig.gameSpeed) || (last_sound_cpu != myGlobalConfig.soundCPU) || (last_sound_low != low) ||
+        (myGlobalConfig.soundCPU && (last_arm7_rate != arm7_rate)))
     {
         last_game_speed = myConfig.gameSpeed;
-        mmStreamClose();
-
-        // Adjust the sample rate to match the core emulation speed... user can override from 80% to 120%
-        int new_sample_rate     = (sample_rate * sample_rate_adjust[myConfig.gameSpeed]) / 100;
-        myStream.sampling_rate  = new_sample_rate;        // sample_rate for the ZX to match the AY/Beeper drivers
-        myStream.buffer_length  = buffer_size;            // buffer length = (512+16)
-        myStream.callback       = OurSoundMixer;          // set callback function
-        myStream.format         = MM_STREAM_16BIT_STEREO; // format = stereo 16-bit
-        myStream.timer          = MM_TIMER0;              // use hardware timer 0
-        myStream.manual         = false;                  // use automatic filling
-        mmStreamOpen(&myStream);
+        last_arm7_rate = arm7_rate;
+
+        if (myGlobalConfig.soundCPU)
+        {
+            if (!last_sound_cpu) mmStreamClose();
+            sound_arm7_start(arm7_rate);
+        }
+        else
+        {
+            if (last_sound_cpu) sound_arm7_stop();
+            else mmStreamClose();
+            myStream.sampling_rate = sample_rate >> low;
+            mmStreamOpen(&myStream);
+        }
+        last_sound_cpu = myGlobalConfig.soundCPU;
+        last_sound_low = low;
     }
 }
 
@@ -340,23 +268,6 @@ void setupStream(void)
   //----------------------------------------------------------------
 }
 
-void sound_chip_reset()
-{
-  memset(mixer,   0x00, sizeof(mixer));
-  mixer_read=0;
-  mixer_write=0;
-
-  //  --------------------------------------------------------------------
-  //  The AY sound chip is for the ZX Spectrum 128K
-  //  --------------------------------------------------------------------
-  ay38910Reset(&myAY);             // Reset the "AY" sound chip
-  ay38910IndexW(0x07, &myAY);      // Register 7 is ENABLE
-  ay38910DataW(0x3F, &myAY);       // All OFF (negative logic)
-  ay38910Mixer(4, mixbufAY, &myAY);// Do an initial mix conversion to clear the output
-
-  memset(mixbufAY, 0x00, sizeof(mixbufAY));
-}
-
 // -----------------------------------------------------------------------
 // We setup the sound chips - disabling all volumes to start.
 // -----------------------------------------------------------------------
@@ -427,6 +338,86 @@ int getMemFree() { // returns the amount of free memory in bytes
    return mi.fordblks + (getHeapLimit() - getHeapEnd());
 }
 
+#ifdef Z80_PROFILE
+// ----------------------------------------------------------------------
+// The Z80 profiler counts opcodes for each prefix page and buckets the
+// PC into 256 byte chunks. Here we rank them and show the busiest as
+// a percentage of everything counted since the last reset.
+// ----------------------------------------------------------------------
+static const char *prof_page_names[Z80_PROF_PAGES] = {"", "CB", "ED", "DD", "FD", "DDCB", "FDCB"};
+
+static u32 ProfileTotal(const u32 *counts, int size)
+{
+    u32 total = 0;
+    for (int i=0; i<size; i++) total += counts[i];
+    return total ? total:1;
+}
+
+static u32 ProfilePermille(u32 count, u32 total)
+{
+    return (u32)(((u64)count * 1000) / total);
+}
+
+void ShowProfileZ80(void)
+{
+    u16 top[8];
+    u8 idx = 2;
+
+    u32 total = ProfileTotal(Z80_ProfPC, 256);
+    int found = TopProfileZ80(Z80_ProfPC, 256, 8, top);
+    DSPrint(17,idx++, 6, "TOP PC         ");
+    for (int i=0; i<8; i++)
+    {
+        if (i < found)
+        {
+            u32 pm = ProfilePermille(Z80_ProfPC[top[i]], total);
+            sprintf(tmp, "%02X00 %3lu.%lu%%    ", top[i], pm/10, pm%10);
+        } else strcpy(tmp, "               ");
+        DSPrint(17,idx++, 7, tmp);
+    }
+
+    total = ProfileTotal(&Z80_ProfOps[0][0], Z80_PROF_PAGES*256);
+    found = TopProfileZ80(&Z80_ProfOps[0][0], Z80_PROF_PAGES*256, 8, top);
+    DSPrint(17,idx++, 6, "TOP OP         ");
+    for (int i=0; i<8; i++)
+    {
+        if (i < found)
+        {
+            u32 pm = ProfilePermille(Z80_ProfOps[top[i]>>8][top[i]&0xFF], total);
+            sprintf(tmp, "%-4s%02X %3lu.%lu%%  ", prof_page_names[top[i]>>8], top[i]&0xFF, pm/10, pm%10);
+        } else strcpy(tmp, "               ");
+        DSPrint(17,idx++, 7, tmp);
+    }
+}
+
+// ----------------------------------------------------------------------
+// Write out a longer version of the hot-spot lists into the debug log
+// so it can be saved out along with everything else in debug.log
+// ----------------------------------------------------------------------
+void DumpProfileZ80(void)
+{
+    u16 top[64];
+
+    u32 total = ProfileTotal(Z80_ProfPC, 256);
+    int found = TopProfileZ80(Z80_ProfPC, 256, 32, top);
+    debug_printf("Z80 PROFILE - TOP PC (256 byte buckets)\n");
+    for (int i=0; i<found; i++)
+    {
+        u32 pm = ProfilePermille(Z80_ProfPC[top[i]], total);
+        debug_printf("%04X-%04X %10lu %3lu.%lu%%\n", top[i]<<8, (top[i]<<8)|0xFF, Z80_ProfPC[top[i]], pm/10, pm%10);
+    }
+
+    total = ProfileTotal(&Z80_ProfOps[0][0], Z80_PROF_PAGES*256);
+    found = TopProfileZ80(&Z80_ProfOps[0][0], Z80_PROF_PAGES*256, 64, top);
+    debug_printf("Z80 PROFILE - TOP OPCODES\n");
+    for (int i=0; i<found; i++)
+    {
+        u32 pm = ProfilePermille(Z80_ProfOps[top[i]>>8][top[i]&0xFF], total);
+        debug_printf("%-4s %02X %10lu %3lu.%lu%%\n", prof_page_names[top[i]>>8], top[i]&0xFF, Z80_ProfOps[top[i]>>8][top[i]&0xFF], pm/10, pm%10);
+    }
+}
+#endif
+
 void ShowDebugZ80(void)
 {
     u8 idx=2;
@@ -468,9 +459,16 @@ void ShowDebugZ80(void)
         sprintf(tmp, "LOAD: %-9s", loader_type); DSPrint(0,idx++, 7, tmp);
         sprintf(tmp, "MEM Used %dK", getMemUsed()/1024); DSPrint(0,idx++,7, tmp);
         sprintf(tmp, "MEM Free %dK", getMemFree()/1024); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "IDLE %-11lu", zx_idle_last_frame); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "%-7s%c%4luns", render_kernel_names[render_kernel], render_dma ? ' ':'*', render_bench_ns[render_kernel]); DSPrint(0,idx++,7, tmp);
+        sprintf(tmp, "DMA    %c%4luns", render_dma ? '*':' ', render_bench_dma_ns); DSPrint(0,idx++,7, tmp);
 
         // CPU Disassembly!
 
+#ifdef Z80_PROFILE
+        // Profiler builds trade the debug registers for the hot-spot lists
+        ShowProfileZ80();
+#else
         // Put out the debug registers...
         idx = 2;
         for (u8 i=0; i<16; i++)
@@ -479,6 +477,12 @@ void ShowDebugZ80(void)
         }
         sprintf(tmp, "DX %-9lu", DX); DSPrint(17,idx++, 7, tmp);
         sprintf(tmp, "DY %-9lu", DY); DSPrint(17,idx++, 7, tmp);
+#endif
+
+        // The sample ring - underruns and overruns, the average latency and how far the read rate is trimmed (0.01%)
+        idx = 20;
+        sprintf(tmp, "SND U%-4lu O%-4lu", mixer_underruns % 10000, mixer_overruns % 10000); DSPrint(17,idx++,7, tmp);
+        sprintf(tmp, "LAT %3lums %+5ld", ((mixer_fill_avg >> 9) + buffer_size) * 1000 / myStream.sampling_rate, (((s32)mixer_ratio - (1<<16)) * 10000) >> 16); DSPrint(17,idx++,7, tmp);
     }
     else
     {
@@ -1115,6 +1119,7 @@ void SpeccySE_main(void)
 {
   u16 iTx,  iTy;
   u32 ucDEUX;
+  u16 frameStart = 0;
   static u8 dampenClick = 0;
   u8 meta_key = 0;
 
@@ -1154,6 +1159,9 @@ void SpeccySE_main(void)
     // Take a tour of the Z80 counter and display the screen if necessary
     if (!speccy_run())
     {
+        // Let the frameskip controller know how long that frame took against the time it had
+        speccy_frameskip((u16)(TIMER2_DATA - frameStart), GAME_SPEED_PAL[myConfig.gameSpeed]);
+
         // If we've been asked to start the sound engine, rock-and-roll!
         if (bStartSoundEngine)
         {
@@ -1165,7 +1173,7 @@ void SpeccySE_main(void)
         // -------------------------------------------------------------
         if (TIMER1_DATA >= 32728)   //  1000MS (1 sec)
         {
-            char szChai[4];
+            char szChai[7];
 
             TIMER1_CR = 0;
             TIMER1_DATA = 0;
@@ -1181,7 +1189,10 @@ void SpeccySE_main(void)
                 else szChai[0] = ' ';
                 szChai[1] = '0' + (emuFps%100) / 10;
                 szChai[2] = '0' + (emuFps%100) % 10;
-                szChai[3] = 0;
+                szChai[3] = ' ';
+                szChai[4] = zx_frame_skip ? 'S':' ';    // And how many frames we skip after each one drawn
+                szChai[5] = zx_frame_skip ? '0' + zx_frame_skip:' ';
+                szChai[6] = 0;
                 DSPrint(0,0,6,szChai);
             }
             DisplayStatusLine(false);
@@ -1266,6 +1277,7 @@ void SpeccySE_main(void)
                 break;                  // With tape playing, speedup to allow faster load
             }
         }
+        frameStart = TIMER2_DATA;       // And the next frame starts now
 
        // We've run one frame of timing... let the tape player know
        tape_frame();
@@ -1368,7 +1380,9 @@ void SpeccySE_main(void)
       else if ((nds_key & KEY_L) && (nds_key & KEY_R) && (nds_key & KEY_Y))
       {
             DSPrint(5,0,0,"SNAPSHOT");
+            VideoCaptureBegin();
             screenshot();
+            VideoCaptureEnd();
             debug_save();
             WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;WAITVBL;
             DSPrint(5,0,0,"        ");
@@ -1535,6 +1549,7 @@ void speccySEInit(void)
 
 void BottomScreenOptions(void)
 {
+    BorderDMAStop();
     swiWaitForVBlank();
 
     if (bottom_screen != 1)
@@ -1598,6 +1613,7 @@ void BottomScreenKeyboard(void)
 
 void BottomScreenCassette(void)
 {
+    BorderDMAStop();
     swiWaitForVBlank();
 
     // ---------------------------------------------------
@@ -1635,20 +1651,72 @@ void speccySEInitCPU(void)
     BottomScreenKeyboard();
 }
 
+// -------------------------------------------------------------
+// The border colour is changed on every scanline of the bottom
+// screen by an HBlank DMA into palette entry 1 (the keyboard
+// surround) from the table filled in by speccy_run(). The menu
+// screens use that palette entry for themselves so they stop it.
+// -------------------------------------------------------------
+#define BORDER_DMA  0
+
+void BorderDMAStop(void)
+{
+    zx_border_frames = 0;
+    DMA_CR(BORDER_DMA) = 0;
+}
+
+// -------------------------------------------------------------
+// The screenshot captures the display into VRAM bank B - which
+// is where the third screen buffer lives when we triple buffer.
+// Get the picture onto a buffer in bank A, hand bank B over for
+// the capture and then put it back and redraw all the buffers.
+// -------------------------------------------------------------
+void VideoCaptureBegin(void)
+{
+    if (zx_video_buffers < 3) return;
+
+    while (backgroundRenderScreen) swiWaitForVBlank();  // Let any flip that's waiting happen first
+    if (zx_video_show == 2)
+    {
+        dmaCopy((void*)ZX_VIDEO_BUFFER(2), (void*)ZX_VIDEO_BUFFER(0), 256*192);
+        backgroundRenderScreen = 0x80 | 0;
+        swiWaitForVBlank();
+    }
+    vramSetBankB(VRAM_B_LCD);
+}
+
+void VideoCaptureEnd(void)
+{
+    if (zx_video_buffers < 3) return;
+
+    vramSetBankB(VRAM_B_MAIN_BG_0x06020000);
+    zx_screen_dirty_all();
+}
+
 // -------------------------------------------------------------
 // Only used for basic timing of splash screen fade-out
 // -------------------------------------------------------------
 void irqVBlank(void)
 {
-    extern u8 backgroundRenderScreen;
-    
     // Manage time
     vusCptVBL++;
-    if (backgroundRenderScreen) // Only set for DSi mode... double buffer
+    if (backgroundRenderScreen) // Only set for DSi mode... flip to the screen buffer that was just finished
     {
-        dmaCopyWordsAsynch(3, (u16*)(backgroundRenderScreen & 1 ? 0x06820000:0x06830000), (u16*)0x06000000, 64*1024);
+        zx_video_show = backgroundRenderScreen & 0x03;
+        REG_BG3CNT = BG_BMP8_256x256 | BG_BMP_BASE(zx_video_show * 4);
         backgroundRenderScreen = 0;
     }
+
+    DMA_CR(BORDER_DMA) = 0;
+    if (zx_border_frames) // Restart the border colour for the first line and let the DMA take care of the rest
+    {
+        zx_border_frames--;
+        DC_FlushRange(zx_border_show, (ZX_BORDER_DS_LINES+1) * sizeof(u16));
+        BG_PALETTE_SUB[1] = zx_border_show[0];
+        DMA_SRC(BORDER_DMA)  = (u32)&zx_border_show[1];
+        DMA_DEST(BORDER_DMA) = (u32)&BG_PALETTE_SUB[1];
+        DMA_CR(BORDER_DMA)   = DMA_ENABLE | DMA_REPEAT | DMA_START_HBL | DMA_16_BIT | DMA_SRC_INC | DMA_DST_FIX | 1;
+    }
 }
 
 // ----------------------------------------------------------------------
@@ -1876,12 +1944,19 @@ void debug_printf(const char * str, ...)
     vsnprintf(szName, MAX_DPRINTF_STR_SIZE, str, ap);
     va_end(ap);
 
-    strcat(debug_buffer, szName);
-    debug_len += strlen(szName);
+    u32 len = strlen(szName);
+    if ((debug_len + len) < MAX_DEBUG_BUF_SIZE) // Drop anything that won't fit
+    {
+        strcat(debug_buffer, szName);
+        debug_len += len;
+    }
 }
 
 void debug_save()
 {
+#ifdef Z80_PROFILE
+    DumpProfileZ80();
+#endif
     if (debug_len > 0) // Only if we have debug data to write...
     {
         FILE *fp = fopen("debug.log", "w");
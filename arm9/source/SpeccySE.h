@@ -108,6 +108,9 @@ extern u32 DX, DY;
 #define MODE_BIOS           7
 #define MODE_ZX81           8
 
+// Our sample ring buffer between the emulation (producer) and maxmod (consumer) - see OurSoundMixer()
+#define WAVE_DIRECT_BUF_SIZE 2047
+
 #define WAITVBL swiWaitForVBlank(); swiWaitForVBlank(); swiWaitForVBlank(); swiWaitForVBlank(); swiWaitForVBlank();
 
 // -------------------------------------------------------------------------
@@ -120,6 +123,15 @@ extern u32 DX, DY;
 typedef u8 (*patchFunc)(void);
 #define PatchLookup ((patchFunc*)0x06860000)
 
+// ---------------------------------------------------------------------------
+// Timing hooks used by the headless host benchmark (see host/). The host
+// version of nds.h provides these - on the DS they compile away to nothing.
+// ---------------------------------------------------------------------------
+#ifndef PROFILE_BEGIN
+#define PROFILE_BEGIN(slot)
+#define PROFILE_END(slot)
+#endif
+
 extern u8 speccy_mode;
 extern u8 kbd_keys_pressed;
 extern u8 kbd_keys[12];
@@ -136,6 +148,14 @@ extern u16 *pVidDrawBuf;
 extern u16 keyCoresp[MAX_KEY_OPTIONS];
 extern u16 NDS_keyMap[];
 extern u8 soundEmuPause;
+extern u16 mixer_read;
+extern u16 mixer_write;
+extern u32 mixer_ratio;
+extern u32 mixer_fill_avg;
+extern u32 mixer_underruns;
+extern u32 mixer_overruns;
+extern void mixer_set_speed(u32 percent);
+extern u8  audio_low;
 extern int bg0, bg1, bg0b, bg1b;
 extern u32 last_file_size;
 extern u8  zx_special_key;
@@ -145,15 +165,16 @@ extern u16 current_block;
 extern u8  tape_state;
 extern u32 current_block_data_idx;
 extern u32 tape_bytes_processed;
-extern u32 header_pulses;
+extern u32 tape_run_left;
 extern u16 current_bit;
 extern u32 current_bytes_this_block;
-extern u8  custom_pulse_idx;
+extern u16 current_run;
 extern u8  handle_last_bits;
 extern u16 loop_counter;
 extern u16 loop_block;
-extern u32 next_edge1;
-extern u32 next_edge2;
+extern u32 tape_edge_end;
+extern u32 tape_bit_end;
+extern u8  tape_level;
 extern u8 give_up_counter;
 extern u32 last_edge;
 extern u8 bottom_screen;
@@ -162,6 +183,9 @@ extern char *loader_type;
 extern void BottomScreenOptions(void);
 extern void BottomScreenCassette(void);
 extern void BottomScreenKeyboard(void);
+extern void BorderDMAStop(void);
+extern void VideoCaptureBegin(void);
+extern void VideoCaptureEnd(void);
 extern void PauseSound(void);
 extern void UnPauseSound(void);
 extern void ResetStatusFlags(void);
@@ -170,6 +194,16 @@ extern void DisplayStatusLine(bool bForce);
 extern void CassetteInsert(char *filename);
 extern void ResetSpectrum(void);
 extern void processDirectAudio(void);
+extern void beeper_edge(u32 tstates, u8 speaker);
+extern void ay_write(u8 data, u8 value);
+extern u8   ay_read(void);
+extern void audio_frame_end(u32 tstates);
+extern void sound_chip_reset(void);
+extern void sound_arm7_start(u32 rate);
+extern void sound_arm7_stop(void);
+extern void sound_set_quality(u8 low);
+extern void SoundPause(void);
+extern void SoundUnPause(void);
 extern u8   speccyTapePosition(void);
 extern void tape_frame(void);
 extern void debug_init();
@@ -19,6 +19,7 @@
 
 #include "SpeccySE.h"
 #include "SpeccyUtils.h"
+#include "render.h"
 #include "topscreen.h"
 #include "mainmenu.h"
 #include "soundbank.h"
@@ -804,6 +805,9 @@ void SetDefaultGlobalConfig(void)
     myGlobalConfig.showFPS        = 0;    // Don't show FPS counter by default
     myGlobalConfig.lastDir        = 0;    // Default is to start in /roms/speccy
     myGlobalConfig.debugger       = 0;    // Debugger is not shown by default
+    myGlobalConfig.videoBuffers   = 0;    // DSi flips between three screen buffers by default
+    myGlobalConfig.soundCPU       = 0;    // The ARM9 mixes the sound by default
+    myGlobalConfig.soundQuality   = 0;    // AUTO - LOW on the DS-Lite and HIGH on the DSi
 }
 
 void SetDefaultGameConfig(void)
@@ -819,10 +823,10 @@ void SetDefaultGameConfig(void)
     myConfig.autoLoad    = 1;                           // Default is to to auto-load TAP and TZX games
     myConfig.loadAs      = 0;                           // Default load is 48K
     myConfig.gameSpeed   = 0;                           // Default is 100% game speed
-    myConfig.reserved3   = 0;
-    myConfig.reserved4   = 0;
-    myConfig.reserved5   = 0;
-    myConfig.reserved6   = 0;
+    myConfig.idleLoop    = 0;                           // Default is to skip ahead on idle loops
+    myConfig.renderMode  = 0;                           // Default is to render the screen line by line
+    myConfig.frameSkipMin = 0;                          // Default is to draw every frame if we have time...
+    myConfig.frameSkipMax = 0;                          // ...and to skip up to 3 in 4 frames if we don't
     myConfig.reserved7   = 0;
     myConfig.reserved8   = 0xA5;    // So it's easy to spot on an "upgrade" and we can re-default it
     myConfig.reserved9   = 0xA5;    // So it's easy to spot on an "upgrade" and we can re-default it
@@ -905,9 +909,13 @@ const struct options_t Option_Table[2][20] =
         {"AUTO PLAY",      {"NO", "YES"},                                              &myConfig.autoLoad,          2},
         {"AUTO STOP",      {"NO", "YES"},                                              &myConfig.autoStop,          2},
         {"AUTO FIRE",      {"OFF", "ON"},                                              &myConfig.autoFire,          2},
-        {"TAPE SPEED",     {"NORMAL", "ACCELERATED"},                                  &myConfig.tapeSpeed,         2},
+        {"TAPE SPEED",     {"NORMAL", "ACCELERATED", "INSTANT"},                       &myConfig.tapeSpeed,         3},
         {"GAME SPEED",     {"100%", "110%", "120%", "90%", "80%"},                     &myConfig.gameSpeed,         5},
         {"BUS CONTEND",    {"NORMAL", "LIGHT", "HEAVY"},                               &myConfig.contention,        3},
+        {"IDLE LOOPS",     {"SKIP", "RUN"},                                            &myConfig.idleLoop,          2},
+        {"RENDERING",      {"BY LINE", "BY FRAME"},                                    &myConfig.renderMode,        2},
+        {"SKIP MIN",       {"NONE", "1 IN 2", "2 IN 3", "3 IN 4"},                     &myConfig.frameSkipMin,      4},
+        {"SKIP MAX",       {"3 IN 4", "2 IN 3", "1 IN 2", "NONE"},                     &myConfig.frameSkipMax,      4},
         {"NDS D-PAD",      {"NORMAL", "DIAGONALS", "SLIDE-N-GLIDE"},                   &myConfig.dpad,              3},
         
         {NULL,             {"",      ""},                                              NULL,                        1},
@@ -917,6 +925,9 @@ const struct options_t Option_Table[2][20] =
         {"FPS",            {"OFF", "ON", "ON FULLSPEED"},                              &myGlobalConfig.showFPS,     3},
         {"START DIR",      {"/ROMS/SPECCY",  "LAST USED DIR"},                         &myGlobalConfig.lastDir,     2},
         {"DEBUGGER",       {"OFF", "BAD OPS", "DEBUG", "FULL DEBUG"},                  &myGlobalConfig.debugger,    4},
+        {"DSI BUFFERS",    {"TRIPLE", "DOUBLE"},                                       &myGlobalConfig.videoBuffers, 2},
+        {"SOUND CPU",      {"ARM9", "ARM7"},                                           &myGlobalConfig.soundCPU,    2},
+        {"SOUND QUALITY",  {"AUTO", "HIGH", "LOW"},                                   &myGlobalConfig.soundQuality, 3},
         {NULL,             {"",      ""},                                              NULL,                        1},
     }
 };
@@ -1639,9 +1650,15 @@ u8 spectrumInit(char *szGame)
   // -----------------------------------------------------------------
   videoSetMode(MODE_5_2D | DISPLAY_BG3_ACTIVE);
   vramSetBankA(VRAM_A_MAIN_BG_0x06000000);      // This is our top emulation screen (where the game is played)
-  vramSetBankB(VRAM_B_LCD);
+
+  // The DSi flips between screen buffers at 0x06000000, 0x06010000 and (triple buffered) 0x06020000
+  zx_video_buffers = isDSiMode() ? (myGlobalConfig.videoBuffers ? 2:3) : 1;
+  zx_video_show = 0;
+  backgroundRenderScreen = 0;
+  if (zx_video_buffers > 2) vramSetBankB(VRAM_B_MAIN_BG_0x06020000);
+  else vramSetBankB(VRAM_B_LCD);
   
-  REG_BG3CNT = BG_BMP8_256x256;
+  REG_BG3CNT = BG_BMP8_256x256 | BG_BMP_BASE(0);
   REG_BG3PA = (1<<8);
   REG_BG3PB = 0;
   REG_BG3PC = 0;
@@ -1649,6 +1666,9 @@ u8 spectrumInit(char *szGame)
   REG_BG3X = 0;
   REG_BG3Y = 0;
 
+  // Time the character cell renderers in the last screen buffer and draw with the fastest (see render.c)
+  render_benchmark((u32*)ZX_VIDEO_BUFFER(zx_video_buffers-1));
+
   // Init the page flipping buffer...
   for (uBcl=0;uBcl<192;uBcl++)
   {
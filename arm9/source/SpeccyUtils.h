@@ -72,9 +72,9 @@ struct __attribute__((__packed__)) GlobalConfig_t
     u8  global_07;
     u8  global_08;
     u8  global_09;
-    u8  global_10;
-    u8  global_11;
-    u8  global_12;
+    u8  videoBuffers;
+    u8  soundCPU;
+    u8  soundQuality;
     u8  debugger;
     u32 config_checksum;
 };
@@ -91,10 +91,10 @@ struct __attribute__((__packed__)) Config_t
     u8  autoLoad;
     u8  loadAs;
     u8  gameSpeed;
-    u8  reserved3;
-    u8  reserved4;
-    u8  reserved5;
-    u8  reserved6;
+    u8  idleLoop;
+    u8  renderMode;
+    u8  frameSkipMin;
+    u8  frameSkipMax;
     u8  reserved7;
     u8  reserved8;
     u8  reserved9;
@@ -126,6 +126,25 @@ extern u8 portFE, portFD;
 extern u8 zx_AY_enabled;
 extern u8 zx_128k_mode;
 extern u8 zx_ScreenRendering;
+extern u8 zx_contend_table[4];
+extern u8 zx_ula_contend[256];
+extern u8 zx_screen_slot[4];
+extern u8 zx_dirty_rows[192];
+extern u8 zx_beam_render;
+
+#define ZX_DIRTY_BUF(b)  (1 << (b))  // One bit for each of the screen buffers
+#define ZX_DIRTY_ALL     0xFF
+
+#define ZX_VIDEO_BUFFER(b)  (0x06000000 + ((b) << 16))  // Screen buffers are 64K apart in main BG VRAM
+extern u8 backgroundRenderScreen;
+extern u8 zx_video_buffers, zx_video_show;
+extern u8 zx_frame_skip;
+extern u32 zx_contend_base;
+
+#define ZX_BORDER_DS_LINES  192 // The border colour is shown for each line alongside the screen
+extern u16 *zx_border_show;
+extern u8  zx_border_frames;
+extern u32 zx_idle_skipped, zx_idle_last_frame;
 
 extern u8 SpectrumBios[0x4000];
 extern u8 SpectrumBios128[0x8000];
@@ -163,13 +182,21 @@ extern u8   cpu_readport_speccy(register unsigned short Port);
 extern void cpu_writeport_speccy(register unsigned short Port,register unsigned char Value);
 extern void speccy_decompress_z80(int romSize);
 extern void speccy_reset(void);
+extern void zx_contend_rebuild(void);
+extern void zx_contend_set_base(void);
+extern void zx_screen_rebuild(void);
+extern void zx_screen_dirty_all(void);
+extern void zx_beam_log_write(u32 tstates, u16 offset, u8 value);
 extern u32  speccy_run(void);
+extern void speccy_frameskip(u32 busy, u32 budget);
+extern void speccy_frameskip_reset(void);
 extern u8   tape_pulse(void);
 extern void tape_reset(void);
 extern void tape_patch(void);
 extern void tape_stop(void);
 extern void tape_play(void);
 extern void tape_position(u8 newPos);
+extern void tape_rebuild(void);
 extern u8   tape_find_positions(void);
 extern u8   tape_is_playing(void);
 extern void tape_parse_blocks(int tapeSize);
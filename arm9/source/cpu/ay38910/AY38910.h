@@ -85,6 +85,16 @@ int ay38910GetStateSize(void);
  */
 void ay38910Mixer(int count, s16 *dest, AY38910 *chip);
 
+/**
+ * As ay38910Mixer but clocks the chip twice as far for each sample for
+ * the same work - each pass of the oversampling loop is two chip ticks.
+ * Built from AY38910Lo.s.
+ * @param  count: Number of samples to render.
+ * @param  *dest: Pointer to buffer where sound is rendered.
+ * @param  *chip: The AY38910 chip.
+ */
+void ay38910MixerLo(int count, s16 *dest, AY38910 *chip);
+
 /**
  * Write index/register value to the AY38910 chip
  * @param  index: index to write.
@@ -33,9 +33,18 @@
 	.equ FSHIFT, 1+USHIFT
 #endif
 
+#ifdef AY_TWOTICK
+;@ Each pass of the mix loop is two chip ticks. A counter with a period of 1
+;@ (and a written period of 0 is stored as 1) then runs out twice in a pass
+;@ which the mix loop checks for after each reload.
+#define AYNOISEADD 0x10000000
+#define AYTONEADD  0x00200000
+#define AYENVADD   0x00020000
+#else
 #define AYNOISEADD 0x08000000
 #define AYTONEADD  0x00100000
 #define AYENVADD   0x00010000
+#endif
 
 	.syntax unified
 	.arm
@@ -75,6 +84,35 @@ ay38910Mixer:				;@ r0=len, r1=dest, ayptr=r2=pointer to struct
 mixLoop:
 	sub r10,r10,r10,lsr#FSHIFT-USHIFT
 innerMixLoop:
+#ifdef AY_TWOTICK
+	adds r3,r3,#AYTONEADD
+	eorcs r9,r9,#0x0000001		;@ Channel A
+	subscs r3,r3,r3,lsl#20
+	subcs r3,r3,r3,lsl#20		;@ Period 1 - toggle once a pass, the same as the one tick mixer.
+	adds r4,r4,#AYTONEADD
+	eorcs r9,r9,#0x00000002		;@ Channel B
+	subscs r4,r4,r4,lsl#20
+	subcs r4,r4,r4,lsl#20
+	adds r5,r5,#AYTONEADD
+	eorcs r9,r9,#0x00000004		;@ Channel C
+	subscs r5,r5,r5,lsl#20
+	subcs r5,r5,r5,lsl#20
+
+	adds r6,r6,#AYNOISEADD
+	subcs r6,r6,r6,lsl#27
+	tstcs r6,#0xF8000000		;@ Only period 1 reloads to 0, the carry is kept.
+	bleq noiseRanOutTwice
+	orrcs r9,r9,#0x00000038		;@ Clear noise channel.
+	movscs r7,r7,lsr#1
+	eorcs r7,r7,#WFEED
+	eorcs r9,r9,#0x00000038		;@ Noise channel.
+
+	adds r8,r8,#AYENVADD
+	addcs r9,r9,#0x08000000
+	subscs r8,r8,r8,lsl#16
+	subcs r8,r8,r8,lsl#16
+	addcs r9,r9,#0x08000000		;@ Period 1 - two envelope steps.
+#else
 	adds r3,r3,#AYTONEADD
 	subcs r3,r3,r3,lsl#20
 	eorcs r9,r9,#0x0000001		;@ Channel A
@@ -95,6 +133,7 @@ innerMixLoop:
 	adds r8,r8,#AYENVADD
 	subcs r8,r8,r8,lsl#16
 	addcs r9,r9,#0x08000000
+#endif
 	tst r9,r9,lsl#15			;@ Envelope Hold
 	bicmi r9,r9,#0x78000000
 	orr r12,r9,r9,lsr#10		;@ Channels disable.
@@ -131,6 +170,17 @@ innerMixLoop:
 	ldmfd sp!,{r4-r11,lr}
 	bx lr
 
+#ifdef AY_TWOTICK
+;@----------------------------------------------------------------------------
+noiseRanOutTwice:			;@ Period 1, r6 = pos+freq, r7 = noise generator.
+;@----------------------------------------------------------------------------
+	sub r6,r6,r6,lsl#27
+	movs r7,r7,lsr#1
+	eorcs r7,r7,#WFEED
+	cmp r7,#0					;@ Set carry for the second step in the mix loop.
+	bx lr
+#endif
+
 #ifdef NDS
 	.section .dtcm				;@ For the NDS ARM9
 	.align 2
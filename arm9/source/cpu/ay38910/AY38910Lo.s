@@ -0,0 +1,19 @@
+;@
+;@  AY38910Lo.s
+;@  The AY-3-8910 mixer built once more for the LOW sound quality of SpeccySE.
+;@
+;@  Each pass of the mix loop is two chip ticks (see AY_TWOTICK) so a sample
+;@  which covers twice the time costs only a little more than before. Only the
+;@  mixer is wanted - everything else is renamed out of the way of AY38910.s.
+;@
+#define AY_TWOTICK
+#define ay38910Mixer		ay38910MixerLo
+#define ay38910Reset		ay38910ResetLo
+#define ay38910SaveState	ay38910SaveStateLo
+#define ay38910LoadState	ay38910LoadStateLo
+#define ay38910GetStateSize	ay38910GetStateSizeLo
+#define ay38910IndexW		ay38910IndexWLo
+#define ay38910DataW		ay38910DataWLo
+#define ay38910DataR		ay38910DataRLo
+
+#include "AY38910.s"
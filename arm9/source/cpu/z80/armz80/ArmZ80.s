@@ -0,0 +1,1228 @@
+;@
+;@  ArmZ80.s
+;@  ARM assembly main loop for the SpeccySE Z80 core.
+;@
+;@  This is a drop-in replacement for ExecZ80_Speccy() in cz80/Z80.c which
+;@  keeps the Z80 PC, SP, A, F and the T-state counter in ARM registers from
+;@  one instruction to the next. The main opcode page is handled here and
+;@  anything else (the CB/DD/ED/FD prefixes, DAA, EI, IN and OUT along with
+;@  DEC A and DJNZ when a tape patch is sitting on them) is handed back to
+;@  the C core one opcode at a time through ExecOpcodeZ80(). The timing and
+;@  flags are exactly those of the C core so the two can be A/B compared.
+;@
+;@  Build with 'make Z80_ASM=1' to use this instead of the C main loop.
+;@
+#if defined(__arm__) && defined(Z80_ASM)
+
+	.global ExecZ80_Speccy
+
+	.extern CPU
+	.extern MemoryMap
+	.extern zx_contend_table
+	.extern zx_ula_contend
+	.extern zx_contend_base
+	.extern zx_screen_slot
+	.extern zx_dirty_rows
+	.extern zx_beam_render
+	.extern zx_beam_log_write
+	.extern zx_idle_loop
+	.extern zx_idle_skipped
+	.extern ExecOpcodeZ80
+
+;@ Register usage. The Z80 PC and SP are always kept wrapped to 16 bits.
+;@ r0-r3 and r12 are scratch.
+#define z80pc	r4
+#define z80sp	r5
+#define z80a	r6
+#define z80f	r7
+#define cycles	r8
+#define runto	r9
+#define cpuptr	r10
+#define memmap	r11
+
+	.equ PatchLookup,	0x06860000	;@ Tape patch table - one pointer per address
+
+								;@ Offsets into the Z80 struct (see cz80/Z80.h)
+	.equ cpu_pc,	0
+	.equ cpu_f,		2
+	.equ cpu_a,		3
+	.equ cpu_c,		4
+	.equ cpu_b,		5
+	.equ cpu_bc,	4
+	.equ cpu_e,		6
+	.equ cpu_d,		7
+	.equ cpu_de,	6
+	.equ cpu_l,		8
+	.equ cpu_h,		9
+	.equ cpu_hl,	8
+	.equ cpu_sp,	14
+	.equ cpu_af1,	16
+	.equ cpu_bc1,	18
+	.equ cpu_de1,	20
+	.equ cpu_hl1,	22
+	.equ cpu_iff,	24
+	.equ cpu_r,		32
+	.equ cpu_tstates, 36
+
+	.equ S_FLAG,	0x80
+	.equ Z_FLAG,	0x40
+	.equ H_FLAG,	0x10
+	.equ P_FLAG,	0x04
+	.equ V_FLAG,	0x04
+	.equ N_FLAG,	0x02
+	.equ C_FLAG,	0x01
+
+	.equ IFF_1,		0x01
+	.equ IFF_2,		0x08
+	.equ IFF_EI,	0x20
+	.equ IFF_HALT,	0x80
+
+	.syntax unified
+	.arm
+
+;@----------------------------------------------------------------------------
+;@ Helper macros
+;@----------------------------------------------------------------------------
+	.macro mask16 reg			;@ Wrap a register to 16 bits
+	mov \reg,\reg,lsl#16
+	mov \reg,\reg,lsr#16
+	.endm
+
+	.macro incpc				;@ PC++
+	add z80pc,z80pc,#1
+	bic z80pc,z80pc,#0x10000
+	.endm
+
+	.macro opbyte reg			;@ reg = OpZ80(PC++) - no contention. Trashes r1.
+	mov r1,z80pc,lsr#14
+	ldr r1,[memmap,r1,lsl#2]
+	bic \reg,z80pc,#0xC000
+	ldrb \reg,[r1,\reg]
+	incpc
+	.endm
+
+	.macro opword reg			;@ reg = little endian word at PC, PC+=2. Trashes r1,r2.
+	opbyte \reg
+	opbyte r2
+	orr \reg,\reg,r2,lsl#8
+	.endm
+
+	.macro getr dst,reg			;@ dst = 8-bit Z80 register
+	.ifc \reg,a
+	mov \dst,z80a
+	.else
+	ldrb \dst,[cpuptr,#cpu_\reg]
+	.endif
+	.endm
+
+	.macro setr reg,src			;@ 8-bit Z80 register = src (already 8 bits)
+	.ifc \reg,a
+	mov z80a,\src
+	.else
+	strb \src,[cpuptr,#cpu_\reg]
+	.endif
+	.endm
+
+	.macro save_state			;@ Hand our registers back to the CPU struct
+	strh z80pc,[cpuptr,#cpu_pc]
+	strh z80sp,[cpuptr,#cpu_sp]
+	strb z80f,[cpuptr,#cpu_f]
+	strb z80a,[cpuptr,#cpu_a]
+	str cycles,[cpuptr,#cpu_tstates]
+	.endm
+
+	.macro load_state			;@ And pick them up again
+	ldrh z80pc,[cpuptr,#cpu_pc]
+	ldrh z80sp,[cpuptr,#cpu_sp]
+	ldrb z80f,[cpuptr,#cpu_f]
+	ldrb z80a,[cpuptr,#cpu_a]
+	ldr cycles,[cpuptr,#cpu_tstates]
+	.endm
+
+	.macro push16				;@ Push r12. Trashes r0-r3.
+	sub z80sp,z80sp,#1
+	mask16 z80sp
+	mov r0,z80sp
+	mov r1,r12,lsr#8
+	bl z80_write
+	sub z80sp,z80sp,#1
+	mask16 z80sp
+	mov r0,z80sp
+	and r1,r12,#0xFF
+	bl z80_write
+	.endm
+
+	.macro pop16				;@ Pop into r12. Trashes r0-r3.
+	mov r0,z80sp
+	bl z80_read
+	mov r12,r0
+	add z80sp,z80sp,#1
+	bic z80sp,z80sp,#0x10000
+	mov r0,z80sp
+	bl z80_read
+	orr r12,r12,r0,lsl#8
+	add z80sp,z80sp,#1
+	bic z80sp,z80sp,#0x10000
+	.endm
+
+#ifdef NDS
+	.section .itcm,"ax"			;@ For the NDS
+#else
+	.section .text
+#endif
+	.align 2
+;@----------------------------------------------------------------------------
+;@ void ExecZ80_Speccy(u32 RunToCycles)
+;@ Run the Z80 until CPU.TStates reaches RunToCycles.
+;@----------------------------------------------------------------------------
+ExecZ80_Speccy:
+	.type ExecZ80_Speccy STT_FUNC
+;@----------------------------------------------------------------------------
+	stmfd sp!,{r3-r11,lr}		;@ r3 keeps the stack 8 byte aligned for C calls
+	mov runto,r0
+	ldr cpuptr,=CPU
+	ldr memmap,=MemoryMap
+	load_state
+;@----------------------------------------------------------------------------
+z80_next:						;@ Fetch, contend and dispatch the next opcode
+;@----------------------------------------------------------------------------
+	cmp cycles,runto
+	bhs z80_exit
+	ldr r2,=zx_contend_table
+	ldrb r2,[r2,z80pc,lsr#14]
+	cmp r2,#0
+	blne z80_contend			;@ Opcode fetch from contended memory
+	opbyte r0
+	ldr r1,=z80_cycles
+	ldrb r1,[r1,r0]
+	add cycles,cycles,r1
+	ldr r1,[cpuptr,#cpu_r]		;@ R register incremented on each M1 cycle
+	add r1,r1,#1
+	str r1,[cpuptr,#cpu_r]
+	ldr pc,[pc,r0,lsl#2]
+	nop
+;@----------------------------------------------------------------------------
+	.word opNOP,      opLD_BC_WORD, opLD_xBC_A,    opINC_BC,    opINC_B,    opDEC_B,    opLD_B_BYTE,   opRLCA		;@ 0x00
+	.word opEX_AF_AF, opADD_HL_BC,  opLD_A_xBC,    opDEC_BC,    opINC_C,    opDEC_C,    opLD_C_BYTE,   opRRCA		;@ 0x08
+	.word opDJNZ,     opLD_DE_WORD, opLD_xDE_A,    opINC_DE,    opINC_D,    opDEC_D,    opLD_D_BYTE,   opRLA		;@ 0x10
+	.word opJR,       opADD_HL_DE,  opLD_A_xDE,    opDEC_DE,    opINC_E,    opDEC_E,    opLD_E_BYTE,   opRRA		;@ 0x18
+	.word opJR_NZ,    opLD_HL_WORD, opLD_xWORD_HL, opINC_HL,    opINC_H,    opDEC_H,    opLD_H_BYTE,   z80_c_core	;@ 0x20 DAA
+	.word opJR_Z,     opADD_HL_HL,  opLD_HL_xWORD, opDEC_HL,    opINC_L,    opDEC_L,    opLD_L_BYTE,   opCPL		;@ 0x28
+	.word opJR_NC,    opLD_SP_WORD, opLD_xWORD_A,  opINC_SP,    opINC_xHL,  opDEC_xHL,  opLD_xHL_BYTE, opSCF		;@ 0x30
+	.word opJR_C,     opADD_HL_SP,  opLD_A_xWORD,  opDEC_SP,    opINC_A,    opDEC_A,    opLD_A_BYTE,   opCCF		;@ 0x38
+	.word opNOP,      opLD_B_C,     opLD_B_D,      opLD_B_E,    opLD_B_H,   opLD_B_L,   opLD_B_xHL,    opLD_B_A		;@ 0x40
+	.word opLD_C_B,   opNOP,        opLD_C_D,      opLD_C_E,    opLD_C_H,   opLD_C_L,   opLD_C_xHL,    opLD_C_A		;@ 0x48
+	.word opLD_D_B,   opLD_D_C,     opNOP,         opLD_D_E,    opLD_D_H,   opLD_D_L,   opLD_D_xHL,    opLD_D_A		;@ 0x50
+	.word opLD_E_B,   opLD_E_C,     opLD_E_D,      opNOP,       opLD_E_H,   opLD_E_L,   opLD_E_xHL,    opLD_E_A		;@ 0x58
+	.word opLD_H_B,   opLD_H_C,     opLD_H_D,      opLD_H_E,    opNOP,      opLD_H_L,   opLD_H_xHL,    opLD_H_A		;@ 0x60
+	.word opLD_L_B,   opLD_L_C,     opLD_L_D,      opLD_L_E,    opLD_L_H,   opNOP,      opLD_L_xHL,    opLD_L_A		;@ 0x68
+	.word opLD_xHL_B, opLD_xHL_C,   opLD_xHL_D,    opLD_xHL_E,  opLD_xHL_H, opLD_xHL_L, opHALT,        opLD_xHL_A	;@ 0x70
+	.word opLD_A_B,   opLD_A_C,     opLD_A_D,      opLD_A_E,    opLD_A_H,   opLD_A_L,   opLD_A_xHL,    opNOP		;@ 0x78
+	.word opADD_B,    opADD_C,      opADD_D,       opADD_E,     opADD_H,    opADD_L,    opADD_xHL,     opADD_A		;@ 0x80
+	.word opADC_B,    opADC_C,      opADC_D,       opADC_E,     opADC_H,    opADC_L,    opADC_xHL,     opADC_A		;@ 0x88
+	.word opSUB_B,    opSUB_C,      opSUB_D,       opSUB_E,     opSUB_H,    opSUB_L,    opSUB_xHL,     opSUB_A		;@ 0x90
+	.word opSBC_B,    opSBC_C,      opSBC_D,       opSBC_E,     opSBC_H,    opSBC_L,    opSBC_xHL,     opSBC_A		;@ 0x98
+	.word opAND_B,    opAND_C,      opAND_D,       opAND_E,     opAND_H,    opAND_L,    opAND_xHL,     opAND_A		;@ 0xA0
+	.word opXOR_B,    opXOR_C,      opXOR_D,       opXOR_E,     opXOR_H,    opXOR_L,    opXOR_xHL,     opXOR_A		;@ 0xA8
+	.word opOR_B,     opOR_C,       opOR_D,        opOR_E,      opOR_H,     opOR_L,     opOR_xHL,      opOR_A		;@ 0xB0
+	.word opCP_B,     opCP_C,       opCP_D,        opCP_E,      opCP_H,     opCP_L,     opCP_xHL,      opCP_A		;@ 0xB8
+	.word opRET_NZ,   opPOP_BC,     opJP_NZ,       opJP,        opCALL_NZ,  opPUSH_BC,  opADD_BYTE,    opRST00		;@ 0xC0
+	.word opRET_Z,    opRET,        opJP_Z,        z80_c_core,  opCALL_Z,   opCALL,     opADC_BYTE,    opRST08		;@ 0xC8 CB
+	.word opRET_NC,   opPOP_DE,     opJP_NC,       z80_c_core,  opCALL_NC,  opPUSH_DE,  opSUB_BYTE,    opRST10		;@ 0xD0 OUT (n),A
+	.word opRET_C,    opEXX,        opJP_C,        z80_c_core,  opCALL_C,   z80_c_core, opSBC_BYTE,    opRST18		;@ 0xD8 IN A,(n) DD
+	.word opRET_PO,   opPOP_HL,     opJP_PO,       opEX_HL_xSP, opCALL_PO,  opPUSH_HL,  opAND_BYTE,    opRST20		;@ 0xE0
+	.word opRET_PE,   opLD_PC_HL,   opJP_PE,       opEX_DE_HL,  opCALL_PE,  z80_c_core, opXOR_BYTE,    opRST28		;@ 0xE8 ED
+	.word opRET_P,    opPOP_AF,     opJP_P,        opDI,        opCALL_P,   opPUSH_AF,  opOR_BYTE,     opRST30		;@ 0xF0
+	.word opRET_M,    opLD_SP_HL,   opJP_M,        z80_c_core,  opCALL_M,   z80_c_core, opCP_BYTE,     opRST38		;@ 0xF8 EI FD
+
+;@----------------------------------------------------------------------------
+z80_exit:
+	save_state
+	ldmfd sp!,{r3-r11,pc}
+
+;@----------------------------------------------------------------------------
+z80_c_core:						;@ r0 = opcode. Let the C core run this one.
+;@----------------------------------------------------------------------------
+	save_state
+	mov r1,runto
+	bl ExecOpcodeZ80
+	load_state
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ Memory contention. The slot mask in zx_contend_table[] is zero for slots
+;@ which are not contended (or when the ULA is not fetching the screen) and
+;@ zx_ula_contend[] is the ULA delay for where we are on the scanline.
+;@----------------------------------------------------------------------------
+z80_contend:					;@ r2 = slot mask (non-zero). Trashes r1-r3.
+	ldr r3,=zx_contend_base
+	ldr r3,[r3]
+	sub r3,cycles,r3
+	and r3,r3,#0xFF
+	ldr r1,=zx_ula_contend
+	ldrb r3,[r1,r3]
+	and r3,r3,r2
+	add cycles,cycles,r3
+	bx lr
+
+;@----------------------------------------------------------------------------
+z80_read:						;@ r0 = address, returns r0 = byte. Trashes r1-r3.
+;@----------------------------------------------------------------------------
+	ldr r2,=zx_contend_table
+	ldrb r1,[r2,r0,lsr#14]
+	cmp r1,#0
+	bne read_contended
+read_go:
+	mov r1,r0,lsr#14
+	ldr r1,[memmap,r1,lsl#2]
+	bic r0,r0,#0xC000
+	ldrb r0,[r1,r0]
+	bx lr
+read_contended:					;@ r1 = slot mask
+	ldr r3,=zx_contend_base
+	ldr r3,[r3]
+	sub r3,cycles,r3
+	and r3,r3,#0xFF
+	ldr r2,=zx_ula_contend
+	ldrb r3,[r2,r3]
+	and r3,r3,r1
+	add cycles,cycles,r3
+	b read_go
+
+;@----------------------------------------------------------------------------
+z80_write:						;@ r0 = address, r1 = byte. Trashes r2,r3.
+;@----------------------------------------------------------------------------
+	ldr r2,=zx_contend_table
+	ldrb r2,[r2,r0,lsr#14]
+	cmp r2,#0
+	bne write_contended
+write_go:
+	movs r3,r0,lsr#14
+#ifndef ZEXALL_TEST
+	bxeq lr						;@ No writing into the ROM
+#endif
+	ldr r2,=zx_screen_slot
+	ldrb r2,[r2,r3]
+	ldr r3,[memmap,r3,lsl#2]
+	cmp r2,#0
+	bic r2,r0,#0xC000
+	bne write_screen
+write_store:
+	strb r1,[r3,r2]
+	bx lr
+write_screen:					;@ r2 = offset into the screen page, r3 = page
+	cmp r2,#0x1B00
+	bhs write_store
+	stmfd sp!,{r0,r12}
+	ldrb r12,[r3,r2]
+	strb r1,[r3,r2]
+	cmp r12,r1
+	beq write_screen_done		;@ Unchanged - nothing to redraw
+	ldr r12,=zx_dirty_rows
+	subs r3,r2,#0x1800
+	bhs write_attr
+	mov r0,r2,lsr#8				;@ Pixel row from the screen address
+	and r0,r0,#0x07
+	and r3,r2,#0xE0
+	orr r0,r0,r3,lsr#2
+	and r3,r2,#0x1800
+	orr r0,r0,r3,lsr#5
+	mov r3,#0xFF
+	strb r3,[r12,r0]
+write_screen_log:
+	ldr r12,=zx_beam_render
+	ldrb r12,[r12]
+	cmp r12,#0
+	beq write_screen_done
+	stmfd sp!,{r1,lr}			;@ Rendering by frame - log the write with its T-state
+	mov r3,r1
+	mov r1,r2
+	mov r2,r3
+	mov r0,cycles
+	bl zx_beam_log_write		;@ r0 = T-states, r1 = offset, r2 = byte
+	ldmfd sp!,{r1,lr}
+write_screen_done:
+	ldmfd sp!,{r0,r12}
+	bx lr
+write_attr:						;@ r3 = offset into the attributes
+	mov r3,r3,lsr#5				;@ An attribute covers 8 pixel rows
+	add r12,r12,r3,lsl#3
+	mvn r3,#0
+	str r3,[r12]
+	str r3,[r12,#4]
+	b write_screen_log
+write_contended:				;@ r2 = slot mask
+	ldr r3,=zx_contend_base
+	ldr r3,[r3]
+	sub r3,cycles,r3
+	and r3,r3,#0xFF
+	ldr r2,=zx_ula_contend
+	ldrb r3,[r2,r3]
+	ldr r2,=zx_contend_table
+	ldrb r2,[r2,r0,lsr#14]
+	and r3,r3,r2
+	add cycles,cycles,r3
+	b write_go
+	.ltorg
+
+;@----------------------------------------------------------------------------
+;@ 8-bit loads
+;@----------------------------------------------------------------------------
+	.macro ld_r_r name,dst,src
+op\name:
+	getr r0,\src
+	setr \dst,r0
+	b z80_next
+	.endm
+
+	.macro ld_r_xhl name,dst
+op\name:
+	ldrh r0,[cpuptr,#cpu_hl]
+	bl z80_read
+	setr \dst,r0
+	b z80_next
+	.endm
+
+	.macro ld_xhl_r name,src
+op\name:
+	ldrh r0,[cpuptr,#cpu_hl]
+	getr r1,\src
+	bl z80_write
+	b z80_next
+	.endm
+
+	.macro ld_r_byte name,dst
+op\name:
+	opbyte r0
+	setr \dst,r0
+	b z80_next
+	.endm
+
+	ld_r_r LD_B_C,b,c
+	ld_r_r LD_B_D,b,d
+	ld_r_r LD_B_E,b,e
+	ld_r_r LD_B_H,b,h
+	ld_r_r LD_B_L,b,l
+	ld_r_r LD_B_A,b,a
+	ld_r_r LD_C_B,c,b
+	ld_r_r LD_C_D,c,d
+	ld_r_r LD_C_E,c,e
+	ld_r_r LD_C_H,c,h
+	ld_r_r LD_C_L,c,l
+	ld_r_r LD_C_A,c,a
+	ld_r_r LD_D_B,d,b
+	ld_r_r LD_D_C,d,c
+	ld_r_r LD_D_E,d,e
+	ld_r_r LD_D_H,d,h
+	ld_r_r LD_D_L,d,l
+	ld_r_r LD_D_A,d,a
+	ld_r_r LD_E_B,e,b
+	ld_r_r LD_E_C,e,c
+	ld_r_r LD_E_D,e,d
+	ld_r_r LD_E_H,e,h
+	ld_r_r LD_E_L,e,l
+	ld_r_r LD_E_A,e,a
+	ld_r_r LD_H_B,h,b
+	ld_r_r LD_H_C,h,c
+	ld_r_r LD_H_D,h,d
+	ld_r_r LD_H_E,h,e
+	ld_r_r LD_H_L,h,l
+	ld_r_r LD_H_A,h,a
+	ld_r_r LD_L_B,l,b
+	ld_r_r LD_L_C,l,c
+	ld_r_r LD_L_D,l,d
+	ld_r_r LD_L_E,l,e
+	ld_r_r LD_L_H,l,h
+	ld_r_r LD_L_A,l,a
+	ld_r_r LD_A_B,a,b
+	ld_r_r LD_A_C,a,c
+	ld_r_r LD_A_D,a,d
+	ld_r_r LD_A_E,a,e
+	ld_r_r LD_A_H,a,h
+	ld_r_r LD_A_L,a,l
+
+	ld_r_xhl LD_B_xHL,b
+	ld_r_xhl LD_C_xHL,c
+	ld_r_xhl LD_D_xHL,d
+	ld_r_xhl LD_E_xHL,e
+	ld_r_xhl LD_H_xHL,h
+	ld_r_xhl LD_L_xHL,l
+	ld_r_xhl LD_A_xHL,a
+
+	ld_xhl_r LD_xHL_B,b
+	ld_xhl_r LD_xHL_C,c
+	ld_xhl_r LD_xHL_D,d
+	ld_xhl_r LD_xHL_E,e
+	ld_xhl_r LD_xHL_H,h
+	ld_xhl_r LD_xHL_L,l
+	ld_xhl_r LD_xHL_A,a
+
+	ld_r_byte LD_B_BYTE,b
+	ld_r_byte LD_C_BYTE,c
+	ld_r_byte LD_D_BYTE,d
+	ld_r_byte LD_E_BYTE,e
+	ld_r_byte LD_H_BYTE,h
+	ld_r_byte LD_L_BYTE,l
+	ld_r_byte LD_A_BYTE,a
+	.ltorg
+
+;@----------------------------------------------------------------------------
+opLD_xHL_BYTE:
+	opbyte r12
+	ldrh r0,[cpuptr,#cpu_hl]
+	mov r1,r12
+	bl z80_write
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_A_xBC:
+	ldrh r0,[cpuptr,#cpu_bc]
+	bl z80_read
+	mov z80a,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_A_xDE:
+	ldrh r0,[cpuptr,#cpu_de]
+	bl z80_read
+	mov z80a,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_xBC_A:
+	ldrh r0,[cpuptr,#cpu_bc]
+	mov r1,z80a
+	bl z80_write
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_xDE_A:
+	ldrh r0,[cpuptr,#cpu_de]
+	mov r1,z80a
+	bl z80_write
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_A_xWORD:
+	opword r0
+	bl z80_read
+	mov z80a,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_xWORD_A:
+	opword r0
+	mov r1,z80a
+	bl z80_write
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ 16-bit loads and exchanges
+;@----------------------------------------------------------------------------
+	.macro ld_rr_word name,reg
+op\name:
+	opword r0
+	strh r0,[cpuptr,#cpu_\reg]
+	b z80_next
+	.endm
+
+	ld_rr_word LD_BC_WORD,bc
+	ld_rr_word LD_DE_WORD,de
+	ld_rr_word LD_HL_WORD,hl
+;@----------------------------------------------------------------------------
+opLD_SP_WORD:
+	opword z80sp
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_SP_HL:
+	ldrh z80sp,[cpuptr,#cpu_hl]
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_xWORD_HL:
+	opword r12
+	mov r0,r12
+	ldrb r1,[cpuptr,#cpu_l]
+	bl z80_write
+	add r0,r12,#1
+	bic r0,r0,#0x10000
+	ldrb r1,[cpuptr,#cpu_h]
+	bl z80_write
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_HL_xWORD:
+	opword r12
+	mov r0,r12
+	bl z80_read
+	strb r0,[cpuptr,#cpu_l]
+	add r0,r12,#1
+	bic r0,r0,#0x10000
+	bl z80_read
+	strb r0,[cpuptr,#cpu_h]
+	b z80_next
+;@----------------------------------------------------------------------------
+opEX_HL_xSP:
+	mov r0,z80sp
+	bl z80_read
+	mov r12,r0
+	mov r0,z80sp
+	ldrb r1,[cpuptr,#cpu_l]
+	bl z80_write
+	add r0,z80sp,#1
+	bic r0,r0,#0x10000
+	bl z80_read
+	orr r12,r12,r0,lsl#8
+	add r0,z80sp,#1
+	bic r0,r0,#0x10000
+	ldrb r1,[cpuptr,#cpu_h]
+	bl z80_write
+	strh r12,[cpuptr,#cpu_hl]
+	b z80_next
+;@----------------------------------------------------------------------------
+opEX_DE_HL:
+	ldrh r0,[cpuptr,#cpu_de]
+	ldrh r1,[cpuptr,#cpu_hl]
+	strh r1,[cpuptr,#cpu_de]
+	strh r0,[cpuptr,#cpu_hl]
+	b z80_next
+;@----------------------------------------------------------------------------
+opEX_AF_AF:
+	ldrb r0,[cpuptr,#cpu_af1]
+	ldrb r1,[cpuptr,#cpu_af1+1]
+	strb z80f,[cpuptr,#cpu_af1]
+	strb z80a,[cpuptr,#cpu_af1+1]
+	mov z80f,r0
+	mov z80a,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+opEXX:
+	ldrh r0,[cpuptr,#cpu_bc]
+	ldrh r1,[cpuptr,#cpu_bc1]
+	strh r1,[cpuptr,#cpu_bc]
+	strh r0,[cpuptr,#cpu_bc1]
+	ldrh r0,[cpuptr,#cpu_de]
+	ldrh r1,[cpuptr,#cpu_de1]
+	strh r1,[cpuptr,#cpu_de]
+	strh r0,[cpuptr,#cpu_de1]
+	ldrh r0,[cpuptr,#cpu_hl]
+	ldrh r1,[cpuptr,#cpu_hl1]
+	strh r1,[cpuptr,#cpu_hl]
+	strh r0,[cpuptr,#cpu_hl1]
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ Stack
+;@----------------------------------------------------------------------------
+	.macro push_rr name,reg
+op\name:
+	ldrh r12,[cpuptr,#cpu_\reg]
+	push16
+	b z80_next
+	.endm
+
+	.macro pop_rr name,reg
+op\name:
+	pop16
+	strh r12,[cpuptr,#cpu_\reg]
+	b z80_next
+	.endm
+
+	push_rr PUSH_BC,bc
+	push_rr PUSH_DE,de
+	push_rr PUSH_HL,hl
+	pop_rr POP_BC,bc
+	pop_rr POP_DE,de
+	pop_rr POP_HL,hl
+;@----------------------------------------------------------------------------
+opPUSH_AF:
+	orr r12,z80f,z80a,lsl#8
+	push16
+	b z80_next
+;@----------------------------------------------------------------------------
+opPOP_AF:
+	pop16
+	and z80f,r12,#0xFF
+	mov z80a,r12,lsr#8
+	b z80_next
+	.ltorg
+
+;@----------------------------------------------------------------------------
+;@ 8-bit arithmetic and logic. The flags are built exactly as the C core
+;@ builds them (no undocumented bits 3 and 5).
+;@----------------------------------------------------------------------------
+	.macro alu name,reg,op
+op\name:
+	getr r0,\reg
+	b alu_\op
+	.endm
+
+	.macro alu_xhl name,op
+op\name:
+	ldrh r0,[cpuptr,#cpu_hl]
+	bl z80_read
+	b alu_\op
+	.endm
+
+	.macro alu_byte name,op
+op\name:
+	opbyte r0
+	b alu_\op
+	.endm
+
+	.irp op,ADD,ADC,SUB,SBC,AND,XOR,OR,CP
+	alu \op\()_B,b,\op
+	alu \op\()_C,c,\op
+	alu \op\()_D,d,\op
+	alu \op\()_E,e,\op
+	alu \op\()_H,h,\op
+	alu \op\()_L,l,\op
+	alu_xhl \op\()_xHL,\op
+	alu_byte \op\()_BYTE,\op
+	.endr
+
+	alu ADD_A,a,ADD
+	alu ADC_A,a,ADC
+	alu SBC_A,a,SBC
+	alu AND_A,a,AND
+	alu OR_A,a,OR
+;@----------------------------------------------------------------------------
+opSUB_A:
+	mov z80a,#0
+	mov z80f,#N_FLAG|Z_FLAG
+	b z80_next
+;@----------------------------------------------------------------------------
+opXOR_A:
+	mov z80a,#0
+	mov z80f,#P_FLAG|Z_FLAG
+	b z80_next
+;@----------------------------------------------------------------------------
+opCP_A:
+	mov z80f,#N_FLAG|Z_FLAG
+	b z80_next
+
+;@----------------------------------------------------------------------------
+alu_ADC:						;@ r0 = operand
+	and r1,z80f,#C_FLAG
+	add r1,r1,z80a
+	add r1,r1,r0
+	b alu_add_res
+alu_ADD:						;@ r0 = operand
+	add r1,z80a,r0
+alu_add_res:					;@ r1 = 9-bit result
+	eor r2,z80a,r0
+	eor r3,r2,r1
+	and z80f,r3,#H_FLAG
+	eor r3,r0,r1
+	bic r3,r3,r2
+	tst r3,#0x80
+	orrne z80f,z80f,#V_FLAG
+	orr z80f,z80f,r1,lsr#8		;@ Carry out of bit 7
+	ands z80a,r1,#0xFF
+	orreq z80f,z80f,#Z_FLAG
+	and r1,z80a,#S_FLAG
+	orr z80f,z80f,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+alu_SBC:						;@ r0 = operand
+	and r1,z80f,#C_FLAG
+	sub r1,z80a,r1
+	sub r1,r1,r0
+	b alu_sub_res
+alu_SUB:						;@ r0 = operand
+	sub r1,z80a,r0
+alu_sub_res:					;@ r1 = result (negative on a borrow)
+	eor r2,z80a,r0
+	eor r3,r2,r1
+	and r3,r3,#H_FLAG
+	orr z80f,r3,#N_FLAG
+	eor r3,z80a,r1
+	and r3,r3,r2
+	tst r3,#0x80
+	orrne z80f,z80f,#V_FLAG
+	tst r1,#0x100
+	orrne z80f,z80f,#C_FLAG
+	ands z80a,r1,#0xFF
+	orreq z80f,z80f,#Z_FLAG
+	and r1,z80a,#S_FLAG
+	orr z80f,z80f,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+alu_CP:							;@ r0 = operand
+	sub r1,z80a,r0
+	eor r2,z80a,r0
+	eor r3,r2,r1
+	and r3,r3,#H_FLAG
+	orr z80f,r3,#N_FLAG
+	eor r3,z80a,r1
+	and r3,r3,r2
+	tst r3,#0x80
+	orrne z80f,z80f,#V_FLAG
+	tst r1,#0x100
+	orrne z80f,z80f,#C_FLAG
+	ands r1,r1,#0xFF
+	orreq z80f,z80f,#Z_FLAG
+	and r1,r1,#S_FLAG
+	orr z80f,z80f,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+alu_AND:						;@ r0 = operand
+	and z80a,z80a,r0
+	ldr r1,=pzs_table
+	ldrb z80f,[r1,z80a]
+	orr z80f,z80f,#H_FLAG
+	b z80_next
+;@----------------------------------------------------------------------------
+alu_OR:							;@ r0 = operand
+	orr z80a,z80a,r0
+	ldr r1,=pzs_table
+	ldrb z80f,[r1,z80a]
+	b z80_next
+;@----------------------------------------------------------------------------
+alu_XOR:						;@ r0 = operand
+	eor z80a,z80a,r0
+	ldr r1,=pzs_table
+	ldrb z80f,[r1,z80a]
+	b z80_next
+	.ltorg
+
+;@----------------------------------------------------------------------------
+;@ 8-bit increment and decrement
+;@----------------------------------------------------------------------------
+	.macro inc_r name,reg
+op\name:
+	getr r0,\reg
+	add r0,r0,#1
+	and r0,r0,#0xFF
+	setr \reg,r0
+	b inc_flags
+	.endm
+
+	.macro dec_r name,reg
+op\name:
+	getr r0,\reg
+	sub r0,r0,#1
+	and r0,r0,#0xFF
+	setr \reg,r0
+	b dec_flags
+	.endm
+
+	inc_r INC_B,b
+	inc_r INC_C,c
+	inc_r INC_D,d
+	inc_r INC_E,e
+	inc_r INC_H,h
+	inc_r INC_L,l
+	inc_r INC_A,a
+	dec_r DEC_B,b
+	dec_r DEC_C,c
+	dec_r DEC_D,d
+	dec_r DEC_E,e
+	dec_r DEC_H,h
+	dec_r DEC_L,l
+;@----------------------------------------------------------------------------
+opDEC_A:
+	ldr r1,=PatchLookup			;@ Tape pre-delay speedup? Let the C core do it.
+	ldr r1,[r1,z80pc,lsl#2]
+	cmp r1,#0
+	bne z80_c_core
+	sub z80a,z80a,#1
+	and z80a,z80a,#0xFF
+	mov r0,z80a
+;@----------------------------------------------------------------------------
+dec_flags:						;@ r0 = result
+	ldr r1,=dec_table
+	ldrb r1,[r1,r0]
+	and z80f,z80f,#C_FLAG
+	orr z80f,z80f,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+inc_flags:						;@ r0 = result
+	ldr r1,=inc_table
+	ldrb r1,[r1,r0]
+	and z80f,z80f,#C_FLAG
+	orr z80f,z80f,r1
+	b z80_next
+;@----------------------------------------------------------------------------
+opINC_xHL:
+	ldrh r0,[cpuptr,#cpu_hl]
+	bl z80_read
+	add r12,r0,#1
+	and r12,r12,#0xFF
+	ldr r1,=inc_table
+	ldrb r1,[r1,r12]
+	and z80f,z80f,#C_FLAG
+	orr z80f,z80f,r1
+	ldrh r0,[cpuptr,#cpu_hl]
+	mov r1,r12
+	bl z80_write
+	b z80_next
+;@----------------------------------------------------------------------------
+opDEC_xHL:
+	ldrh r0,[cpuptr,#cpu_hl]
+	bl z80_read
+	sub r12,r0,#1
+	and r12,r12,#0xFF
+	ldr r1,=dec_table
+	ldrb r1,[r1,r12]
+	and z80f,z80f,#C_FLAG
+	orr z80f,z80f,r1
+	ldrh r0,[cpuptr,#cpu_hl]
+	mov r1,r12
+	bl z80_write
+	b z80_next
+	.ltorg
+
+;@----------------------------------------------------------------------------
+;@ 16-bit arithmetic
+;@----------------------------------------------------------------------------
+	.macro incdec_rr name,reg,op
+op\name:
+	ldrh r0,[cpuptr,#cpu_\reg]
+	\op r0,r0,#1
+	strh r0,[cpuptr,#cpu_\reg]
+	b z80_next
+	.endm
+
+	incdec_rr INC_BC,bc,add
+	incdec_rr INC_DE,de,add
+	incdec_rr INC_HL,hl,add
+	incdec_rr DEC_BC,bc,sub
+	incdec_rr DEC_DE,de,sub
+	incdec_rr DEC_HL,hl,sub
+;@----------------------------------------------------------------------------
+opINC_SP:
+	add z80sp,z80sp,#1
+	bic z80sp,z80sp,#0x10000
+	b z80_next
+;@----------------------------------------------------------------------------
+opDEC_SP:
+	sub z80sp,z80sp,#1
+	mask16 z80sp
+	b z80_next
+
+	.macro add_hl_rr name,reg
+op\name:
+	ldrh r0,[cpuptr,#cpu_\reg]
+	b add_hl
+	.endm
+
+	add_hl_rr ADD_HL_BC,bc
+	add_hl_rr ADD_HL_DE,de
+	add_hl_rr ADD_HL_HL,hl
+;@----------------------------------------------------------------------------
+opADD_HL_SP:
+	mov r0,z80sp
+add_hl:							;@ r0 = operand
+	ldrh r1,[cpuptr,#cpu_hl]
+	add r2,r1,r0
+	eor r3,r1,r0
+	eor r3,r3,r2
+	bic z80f,z80f,#H_FLAG|N_FLAG|C_FLAG
+	tst r3,#0x1000
+	orrne z80f,z80f,#H_FLAG
+	orr z80f,z80f,r2,lsr#16		;@ Carry out of bit 15
+	strh r2,[cpuptr,#cpu_hl]
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ Accumulator rotates and flag operations
+;@----------------------------------------------------------------------------
+opRLCA:
+	mov r0,z80a,lsr#7
+	orr z80a,r0,z80a,lsl#1
+	and z80a,z80a,#0xFF
+	bic z80f,z80f,#C_FLAG|N_FLAG|H_FLAG
+	orr z80f,z80f,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opRLA:
+	mov r0,z80a,lsr#7
+	and r1,z80f,#C_FLAG
+	orr z80a,r1,z80a,lsl#1
+	and z80a,z80a,#0xFF
+	bic z80f,z80f,#C_FLAG|N_FLAG|H_FLAG
+	orr z80f,z80f,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opRRCA:
+	and r0,z80a,#0x01
+	mov z80a,z80a,lsr#1
+	orr z80a,z80a,r0,lsl#7
+	bic z80f,z80f,#C_FLAG|N_FLAG|H_FLAG
+	orr z80f,z80f,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opRRA:
+	and r0,z80a,#0x01
+	mov z80a,z80a,lsr#1
+	and r1,z80f,#C_FLAG
+	orr z80a,z80a,r1,lsl#7
+	bic z80f,z80f,#C_FLAG|N_FLAG|H_FLAG
+	orr z80f,z80f,r0
+	b z80_next
+;@----------------------------------------------------------------------------
+opSCF:
+	orr z80f,z80f,#C_FLAG
+	bic z80f,z80f,#N_FLAG|H_FLAG
+	b z80_next
+;@----------------------------------------------------------------------------
+opCCF:
+	eor z80f,z80f,#C_FLAG
+	bic z80f,z80f,#N_FLAG|H_FLAG
+	tst z80f,#C_FLAG
+	orreq z80f,z80f,#H_FLAG
+	b z80_next
+;@----------------------------------------------------------------------------
+opCPL:
+	eor z80a,z80a,#0xFF
+	orr z80f,z80f,#N_FLAG|H_FLAG
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ Jumps. As in the C core the cycle table assumes a relative jump is taken
+;@ and a call or return is not.
+;@----------------------------------------------------------------------------
+	.macro cond name,flag,set,taken,nottaken
+op\name:
+	tst z80f,#\flag
+	.if \set
+	bne \taken
+	b \nottaken
+	.else
+	beq \taken
+	b \nottaken
+	.endif
+	.endm
+
+	cond JR_NZ,Z_FLAG,0,jr_taken,jr_skip
+	cond JR_Z,Z_FLAG,1,jr_taken,jr_skip
+	cond JR_NC,C_FLAG,0,jr_taken,jr_skip
+	cond JR_C,C_FLAG,1,jr_taken,jr_skip
+
+	cond JP_NZ,Z_FLAG,0,opJP,jp_skip
+	cond JP_Z,Z_FLAG,1,opJP,jp_skip
+	cond JP_NC,C_FLAG,0,opJP,jp_skip
+	cond JP_C,C_FLAG,1,opJP,jp_skip
+	cond JP_PO,P_FLAG,0,opJP,jp_skip
+	cond JP_PE,P_FLAG,1,opJP,jp_skip
+	cond JP_P,S_FLAG,0,opJP,jp_skip
+	cond JP_M,S_FLAG,1,opJP,jp_skip
+
+	cond CALL_NZ,Z_FLAG,0,call_taken,jp_skip
+	cond CALL_Z,Z_FLAG,1,call_taken,jp_skip
+	cond CALL_NC,C_FLAG,0,call_taken,jp_skip
+	cond CALL_C,C_FLAG,1,call_taken,jp_skip
+	cond CALL_PO,P_FLAG,0,call_taken,jp_skip
+	cond CALL_PE,P_FLAG,1,call_taken,jp_skip
+	cond CALL_P,S_FLAG,0,call_taken,jp_skip
+	cond CALL_M,S_FLAG,1,call_taken,jp_skip
+
+	cond RET_NZ,Z_FLAG,0,ret_taken,z80_next
+	cond RET_Z,Z_FLAG,1,ret_taken,z80_next
+	cond RET_NC,C_FLAG,0,ret_taken,z80_next
+	cond RET_C,C_FLAG,1,ret_taken,z80_next
+	cond RET_PO,P_FLAG,0,ret_taken,z80_next
+	cond RET_PE,P_FLAG,1,ret_taken,z80_next
+	cond RET_P,S_FLAG,0,ret_taken,z80_next
+	cond RET_M,S_FLAG,1,ret_taken,z80_next
+;@----------------------------------------------------------------------------
+opJP:
+	opword r0
+	mov z80pc,r0
+	b z80_next
+jp_skip:
+	add z80pc,z80pc,#2
+	mask16 z80pc
+	b z80_next
+;@----------------------------------------------------------------------------
+opLD_PC_HL:
+	ldrh z80pc,[cpuptr,#cpu_hl]
+	b z80_next
+;@----------------------------------------------------------------------------
+call_taken:
+	add cycles,cycles,#7
+opCALL:
+	opword r0
+	mov r12,z80pc				;@ Return address
+	mov z80pc,r0
+	push16
+	b z80_next
+;@----------------------------------------------------------------------------
+ret_taken:
+	add cycles,cycles,#6
+opRET:
+	pop16
+	mov z80pc,r12
+	b z80_next
+;@----------------------------------------------------------------------------
+	.macro rst name,addr
+op\name:
+	mov r12,z80pc
+	mov z80pc,#\addr
+	push16
+	b z80_next
+	.endm
+
+	rst RST00,0x00
+	rst RST08,0x08
+	rst RST10,0x10
+	rst RST18,0x18
+	rst RST20,0x20
+	rst RST28,0x28
+	rst RST30,0x30
+	rst RST38,0x38
+	.ltorg
+;@----------------------------------------------------------------------------
+jr_skip:
+	sub cycles,cycles,#5
+	incpc
+	b z80_next
+;@----------------------------------------------------------------------------
+;@ A taken JR that goes a short way backwards may be an idle loop waiting on
+;@ the frame interrupt. If zx_idle_loop() agrees, skip ahead to the end of
+;@ this run just like HALT does.
+;@----------------------------------------------------------------------------
+opJR:
+jr_taken:
+	sub r12,z80pc,#1			;@ Address of the JR opcode
+	mask16 r12
+	mov r1,z80pc,lsr#14
+	ldr r1,[memmap,r1,lsl#2]
+	bic r0,z80pc,#0xC000
+	ldrsb r0,[r1,r0]
+	add z80pc,z80pc,r0
+	add z80pc,z80pc,#1
+	mask16 z80pc
+	sub r0,r12,z80pc
+	mov r0,r0,lsl#16
+	cmp r0,#0x00100000			;@ Less than 16 bytes back?
+	bhs z80_next
+	cmp cycles,runto
+	bhs z80_next
+	mov r0,z80pc
+	mov r1,r12
+	bl zx_idle_loop
+	cmp r0,#0
+	beq z80_next
+	ldr r1,=zx_idle_skipped
+	ldr r2,[r1]
+	sub r3,runto,cycles
+	add r2,r2,r3
+	str r2,[r1]
+	mov cycles,runto
+	b z80_next
+;@----------------------------------------------------------------------------
+opDJNZ:
+	ldr r1,=PatchLookup			;@ Tape pre-load speedup? Let the C core do it.
+	ldr r1,[r1,z80pc,lsl#2]
+	cmp r1,#0
+	bne z80_c_core
+	ldrb r0,[cpuptr,#cpu_b]
+	sub r0,r0,#1
+	ands r0,r0,#0xFF
+	strb r0,[cpuptr,#cpu_b]
+	beq jr_skip
+	mov r1,z80pc,lsr#14
+	ldr r1,[memmap,r1,lsl#2]
+	bic r0,z80pc,#0xC000
+	ldrsb r0,[r1,r0]
+	add z80pc,z80pc,r0
+	add z80pc,z80pc,#1
+	mask16 z80pc
+	b z80_next
+
+;@----------------------------------------------------------------------------
+;@ Everything else
+;@----------------------------------------------------------------------------
+opNOP:
+	b z80_next
+;@----------------------------------------------------------------------------
+opHALT:							;@ Wait for the interrupt - just skip ahead
+	mov cycles,runto
+	sub z80pc,z80pc,#1
+	mask16 z80pc
+	ldrb r0,[cpuptr,#cpu_iff]
+	orr r0,r0,#IFF_HALT
+	strb r0,[cpuptr,#cpu_iff]
+	b z80_next
+;@----------------------------------------------------------------------------
+opDI:
+	ldrb r0,[cpuptr,#cpu_iff]
+	bic r0,r0,#IFF_1|IFF_2|IFF_EI
+	strb r0,[cpuptr,#cpu_iff]
+	b z80_next
+	.ltorg
+
+;@----------------------------------------------------------------------------
+;@ Tables - copied from cz80/Tables.h
+;@----------------------------------------------------------------------------
+#ifdef NDS
+	.section .dtcm,"aw"			;@ For the NDS ARM9
+#else
+	.section .rodata
+#endif
+	.align 2
+z80_cycles:
+	.byte 0x04,0x0A,0x07,0x06,0x04,0x04,0x07,0x04,0x04,0x0B,0x07,0x06,0x04,0x04,0x07,0x04	;@ 0x00
+	.byte 0x0D,0x0A,0x07,0x06,0x04,0x04,0x07,0x04,0x0C,0x0B,0x07,0x06,0x04,0x04,0x07,0x04	;@ 0x10
+	.byte 0x0C,0x0A,0x10,0x06,0x04,0x04,0x07,0x04,0x0C,0x0B,0x10,0x06,0x04,0x04,0x07,0x04	;@ 0x20
+	.byte 0x0C,0x0A,0x0D,0x06,0x0B,0x0B,0x0A,0x04,0x0C,0x0B,0x0D,0x06,0x04,0x04,0x07,0x04	;@ 0x30
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x40
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x50
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x60
+	.byte 0x07,0x07,0x07,0x07,0x07,0x07,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x70
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x80
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0x90
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0xA0
+	.byte 0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x07,0x04	;@ 0xB0
+	.byte 0x05,0x0A,0x0A,0x0A,0x0A,0x0B,0x07,0x0B,0x05,0x0A,0x0A,0x00,0x0A,0x11,0x07,0x0B	;@ 0xC0
+	.byte 0x05,0x0A,0x0A,0x0B,0x0A,0x0B,0x07,0x0B,0x05,0x04,0x0A,0x0B,0x0A,0x00,0x07,0x0B	;@ 0xD0
+	.byte 0x05,0x0A,0x0A,0x13,0x0A,0x0B,0x07,0x0B,0x05,0x04,0x0A,0x04,0x0A,0x00,0x07,0x0B	;@ 0xE0
+	.byte 0x05,0x0A,0x0A,0x04,0x0A,0x0B,0x07,0x0B,0x05,0x06,0x0A,0x04,0x0A,0x00,0x07,0x0B	;@ 0xF0
+pzs_table:
+	.byte 0x44,0x00,0x00,0x04,0x00,0x04,0x04,0x00,0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04	;@ 0x00
+	.byte 0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04,0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00	;@ 0x10
+	.byte 0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04,0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00	;@ 0x20
+	.byte 0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00,0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04	;@ 0x30
+	.byte 0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04,0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00	;@ 0x40
+	.byte 0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00,0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04	;@ 0x50
+	.byte 0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00,0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04	;@ 0x60
+	.byte 0x00,0x04,0x04,0x00,0x04,0x00,0x00,0x04,0x04,0x00,0x00,0x04,0x00,0x04,0x04,0x00	;@ 0x70
+	.byte 0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84,0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80	;@ 0x80
+	.byte 0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80,0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84	;@ 0x90
+	.byte 0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80,0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84	;@ 0xA0
+	.byte 0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84,0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80	;@ 0xB0
+	.byte 0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80,0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84	;@ 0xC0
+	.byte 0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84,0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80	;@ 0xD0
+	.byte 0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84,0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80	;@ 0xE0
+	.byte 0x84,0x80,0x80,0x84,0x80,0x84,0x84,0x80,0x80,0x84,0x84,0x80,0x84,0x80,0x80,0x84	;@ 0xF0
+inc_table:
+	.byte 0x50,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x00
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x10
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x20
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x30
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x40
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x50
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x60
+	.byte 0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00	;@ 0x70
+	.byte 0x94,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0x80
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0x90
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xA0
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xB0
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xC0
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xD0
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xE0
+	.byte 0x90,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80	;@ 0xF0
+dec_table:
+	.byte 0x42,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x00
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x10
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x20
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x30
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x40
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x50
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x12	;@ 0x60
+	.byte 0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x02,0x16	;@ 0x70
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0x80
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0x90
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xA0
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xB0
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xC0
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xD0
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xE0
+	.byte 0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x82,0x92	;@ 0xF0
+;@----------------------------------------------------------------------------
+	.end
+#endif // #if defined(__arm__) && defined(Z80_ASM)
@@ -25,10 +25,10 @@
 // For the jump instructions, the Cycle[] table builds in assuming the jump WILL be taken
 // which is true about 95% of the time. If the jump is not taken, we compensate ICount.
 // ----------------------------------------------------------------------------------------
-case JR_NZ:   if(CPU.AF.B.l&Z_FLAG) {CPU.TStates-=5; CPU.PC.W++;} else { M_JR; } break;
-case JR_NC:   if(CPU.AF.B.l&C_FLAG) {CPU.TStates-=5; CPU.PC.W++;} else { M_JR; } break;
-case JR_Z:    if(CPU.AF.B.l&Z_FLAG) { M_JR; } else {CPU.TStates-=5; CPU.PC.W++;} break;
-case JR_C:    if(CPU.AF.B.l&C_FLAG) { M_JR; } else {CPU.TStates-=5; CPU.PC.W++;} break;
+case JR_NZ:   if(CPU.AF.B.l&Z_FLAG) {CPU.TStates-=5; CPU.PC.W++;} else { M_JR_IDLE; } break;
+case JR_NC:   if(CPU.AF.B.l&C_FLAG) {CPU.TStates-=5; CPU.PC.W++;} else { M_JR_IDLE; } break;
+case JR_Z:    if(CPU.AF.B.l&Z_FLAG) { M_JR_IDLE; } else {CPU.TStates-=5; CPU.PC.W++;} break;
+case JR_C:    if(CPU.AF.B.l&C_FLAG) { M_JR_IDLE; } else {CPU.TStates-=5; CPU.PC.W++;} break;
 
 case JP_NZ:   if(CPU.AF.B.l&Z_FLAG) CPU.PC.W+=2; else { M_JP; } break;
 case JP_NC:   if(CPU.AF.B.l&C_FLAG) CPU.PC.W+=2; else { M_JP; } break;
@@ -232,7 +232,7 @@ case DJNZ:
   if(--CPU.BC.B.h) { M_JR; } else {CPU.TStates-=5; CPU.PC.W++;} break;
 
 case JP:   M_JP;break;
-case JR:   M_JR;break;
+case JR:   M_JR_IDLE;break;
 case CALL: M_CALL;break;
 case RET:  M_RET;break;
 case SCF:  S(C_FLAG);R(N_FLAG|H_FLAG);break;
@@ -149,9 +149,12 @@ case INI:
   break;
 
 case INIR:
-  I = InZ80(CPU.BC.W);
-  WrZ80(CPU.HL.W++,I);
-  if(--CPU.BC.B.h) { CPU.AF.B.l=N_FLAG; CPU.PC.W-=2; }   // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
+  do
+  {
+    I = InZ80(CPU.BC.W);
+    WrZ80(CPU.HL.W++,I);
+  } while(--CPU.BC.B.h && ED_MORE());
+  if(CPU.BC.B.h)   { CPU.AF.B.l=N_FLAG; CPU.PC.W-=2; }   // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
   else            { CPU.AF.B.l=Z_FLAG|(I&0x80 ? N_FLAG:0); CPU.TStates-=5;}
   break;
 
@@ -163,9 +166,12 @@ case IND:
   break;
 
 case INDR:
-  I = InZ80(CPU.BC.W);
-  WrZ80(CPU.HL.W--,I);
-  if(!--CPU.BC.B.h) { CPU.AF.B.l=N_FLAG; CPU.PC.W-=2; }  // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
+  do
+  {
+    I = InZ80(CPU.BC.W);
+    WrZ80(CPU.HL.W--,I);
+  } while(--CPU.BC.B.h && ED_MORE());
+  if(CPU.BC.B.h)    { CPU.AF.B.l=N_FLAG; CPU.PC.W-=2; }  // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
   else             { CPU.AF.B.l=Z_FLAG|(I&0x80 ? N_FLAG:0); CPU.TStates-=5;}
   break;
 
@@ -177,9 +183,12 @@ case OUTI:
   break;
 
 case OTIR:
-  --CPU.BC.B.h;
-  I=RdZ80(CPU.HL.W++);
-  OutZ80(CPU.BC.W,I);
+  do
+  {
+    --CPU.BC.B.h;
+    I=RdZ80(CPU.HL.W++);
+    OutZ80(CPU.BC.W,I);
+  } while(CPU.BC.B.h && ED_MORE());
   if(CPU.BC.B.h)
   {
     CPU.AF.B.l=N_FLAG|(CPU.HL.B.l+I>255? (C_FLAG|H_FLAG):0);  // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
@@ -200,9 +209,12 @@ case OUTD:
   break;
 
 case OTDR:
-  --CPU.BC.B.h;
-  I=RdZ80(CPU.HL.W--);
-  OutZ80(CPU.BC.W,I);
+  do
+  {
+    --CPU.BC.B.h;
+    I=RdZ80(CPU.HL.W--);
+    OutZ80(CPU.BC.W,I);
+  } while(CPU.BC.B.h && ED_MORE());
   if(CPU.BC.B.h)
   {
     CPU.AF.B.l=N_FLAG|(CPU.HL.B.l+I>255? (C_FLAG|H_FLAG):0);  // N_FLAG is not correct here but will be corrected when loop exits below. Nothing relies on the intermediate value.
@@ -222,8 +234,8 @@ case LDI:
   break;
 
 case LDIR:
-  WrZ80(CPU.DE.W++,RdZ80(CPU.HL.W++));
-  if(--CPU.BC.W)
+  BlockMove(1, RunToCycles);
+  if(CPU.BC.W)
   {
     CPU.AF.B.l=(CPU.AF.B.l&~(H_FLAG|P_FLAG))|N_FLAG;
     CPU.PC.W-=2;
@@ -242,9 +254,8 @@ case LDD:
   break;
 
 case LDDR:
-  WrZ80(CPU.DE.W--,RdZ80(CPU.HL.W--));
-  CPU.AF.B.l&=~(N_FLAG|H_FLAG|P_FLAG);
-  if(--CPU.BC.W)
+  BlockMove(-1, RunToCycles);
+  if(CPU.BC.W)
   {
     CPU.AF.B.l=(CPU.AF.B.l&~(H_FLAG|P_FLAG))|N_FLAG;
     CPU.PC.W-=2;
@@ -266,9 +277,12 @@ case CPI:
   break;
 
 case CPIR:
-  I=RdZ80(CPU.HL.W++);
-  J.B.l=CPU.AF.B.h-I;
-  if(--CPU.BC.W&&J.B.l) { CPU.PC.W-=2; } else {CPU.TStates-=5;}
+  do
+  {
+    I=RdZ80(CPU.HL.W++);
+    J.B.l=CPU.AF.B.h-I;
+  } while(--CPU.BC.W && J.B.l && ED_MORE());
+  if(CPU.BC.W&&J.B.l) { CPU.PC.W-=2; } else {CPU.TStates-=5;}
   CPU.AF.B.l =
     N_FLAG|(CPU.AF.B.l&C_FLAG)|ZSTable[J.B.l]|
     ((CPU.AF.B.h^I^J.B.l)&H_FLAG)|(CPU.BC.W? P_FLAG:0);
@@ -284,9 +298,12 @@ case CPD:
   break;
 
 case CPDR:
-  I=RdZ80(CPU.HL.W--);
-  J.B.l=CPU.AF.B.h-I;
-  if(--CPU.BC.W&&J.B.l) { CPU.PC.W-=2; } else {CPU.TStates-=5;}
+  do
+  {
+    I=RdZ80(CPU.HL.W--);
+    J.B.l=CPU.AF.B.h-I;
+  } while(--CPU.BC.W && J.B.l && ED_MORE());
+  if(CPU.BC.W&&J.B.l) { CPU.PC.W-=2; } else {CPU.TStates-=5;}
   CPU.AF.B.l =
     N_FLAG|(CPU.AF.B.l&C_FLAG)|ZSTable[J.B.l]|
     ((CPU.AF.B.h^I^J.B.l)&H_FLAG)|(CPU.BC.W? P_FLAG:0);
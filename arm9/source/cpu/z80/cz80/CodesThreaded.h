@@ -0,0 +1,258 @@
+/******************************************************************************
+*  SpeccySE Z80 CPU
+*
+* Dispatch tables for the computed-goto (threaded) build of ExecZ80_Speccy().
+* Only used when Z80_THREADED is defined - see Z80.h and Z80.c
+*
+* Each table is one opcode page and holds the address of the handler label
+* for every opcode in that page. The handler labels are the very same names
+* used by the 'case' statements in Codes.h, CodesCB.h, CodesED.h, CodesXX.h
+* and CodesXCB.h (labels live in their own namespace in C so they do not clash
+* with the enum values of the same name). Opcodes which the switch() version
+* sends to 'default' are sent to the matching xx_BadOp label here.
+*
+* If you add or remove a case in one of the Codes*.h files, this table must
+* be updated to match or the threaded build will fail to compile.
+******************************************************************************/
+
+// Main opcode page - the PFX_xx entries jump into the prefix pages below
+#define THREADED_TABLE_MAIN \
+{ \
+  &&NOP,          &&LD_BC_WORD,   &&LD_xBC_A,     &&INC_BC,       &&INC_B,        &&DEC_B,        &&LD_B_BYTE,    &&RLCA,         /* 0x00 */ \
+  &&EX_AF_AF,     &&ADD_HL_BC,    &&LD_A_xBC,     &&DEC_BC,       &&INC_C,        &&DEC_C,        &&LD_C_BYTE,    &&RRCA,         /* 0x08 */ \
+  &&DJNZ,         &&LD_DE_WORD,   &&LD_xDE_A,     &&INC_DE,       &&INC_D,        &&DEC_D,        &&LD_D_BYTE,    &&RLA,          /* 0x10 */ \
+  &&JR,           &&ADD_HL_DE,    &&LD_A_xDE,     &&DEC_DE,       &&INC_E,        &&DEC_E,        &&LD_E_BYTE,    &&RRA,          /* 0x18 */ \
+  &&JR_NZ,        &&LD_HL_WORD,   &&LD_xWORD_HL,  &&INC_HL,       &&INC_H,        &&DEC_H,        &&LD_H_BYTE,    &&DAA,          /* 0x20 */ \
+  &&JR_Z,         &&ADD_HL_HL,    &&LD_HL_xWORD,  &&DEC_HL,       &&INC_L,        &&DEC_L,        &&LD_L_BYTE,    &&CPL,          /* 0x28 */ \
+  &&JR_NC,        &&LD_SP_WORD,   &&LD_xWORD_A,   &&INC_SP,       &&INC_xHL,      &&DEC_xHL,      &&LD_xHL_BYTE,  &&SCF,          /* 0x30 */ \
+  &&JR_C,         &&ADD_HL_SP,    &&LD_A_xWORD,   &&DEC_SP,       &&INC_A,        &&DEC_A,        &&LD_A_BYTE,    &&CCF,          /* 0x38 */ \
+  &&LD_B_B,       &&LD_B_C,       &&LD_B_D,       &&LD_B_E,       &&LD_B_H,       &&LD_B_L,       &&LD_B_xHL,     &&LD_B_A,       /* 0x40 */ \
+  &&LD_C_B,       &&LD_C_C,       &&LD_C_D,       &&LD_C_E,       &&LD_C_H,       &&LD_C_L,       &&LD_C_xHL,     &&LD_C_A,       /* 0x48 */ \
+  &&LD_D_B,       &&LD_D_C,       &&LD_D_D,       &&LD_D_E,       &&LD_D_H,       &&LD_D_L,       &&LD_D_xHL,     &&LD_D_A,       /* 0x50 */ \
+  &&LD_E_B,       &&LD_E_C,       &&LD_E_D,       &&LD_E_E,       &&LD_E_H,       &&LD_E_L,       &&LD_E_xHL,     &&LD_E_A,       /* 0x58 */ \
+  &&LD_H_B,       &&LD_H_C,       &&LD_H_D,       &&LD_H_E,       &&LD_H_H,       &&LD_H_L,       &&LD_H_xHL,     &&LD_H_A,       /* 0x60 */ \
+  &&LD_L_B,       &&LD_L_C,       &&LD_L_D,       &&LD_L_E,       &&LD_L_H,       &&LD_L_L,       &&LD_L_xHL,     &&LD_L_A,       /* 0x68 */ \
+  &&LD_xHL_B,     &&LD_xHL_C,     &&LD_xHL_D,     &&LD_xHL_E,     &&LD_xHL_H,     &&LD_xHL_L,     &&HALT,         &&LD_xHL_A,     /* 0x70 */ \
+  &&LD_A_B,       &&LD_A_C,       &&LD_A_D,       &&LD_A_E,       &&LD_A_H,       &&LD_A_L,       &&LD_A_xHL,     &&LD_A_A,       /* 0x78 */ \
+  &&ADD_B,        &&ADD_C,        &&ADD_D,        &&ADD_E,        &&ADD_H,        &&ADD_L,        &&ADD_xHL,      &&ADD_A,        /* 0x80 */ \
+  &&ADC_B,        &&ADC_C,        &&ADC_D,        &&ADC_E,        &&ADC_H,        &&ADC_L,        &&ADC_xHL,      &&ADC_A,        /* 0x88 */ \
+  &&SUB_B,        &&SUB_C,        &&SUB_D,        &&SUB_E,        &&SUB_H,        &&SUB_L,        &&SUB_xHL,      &&SUB_A,        /* 0x90 */ \
+  &&SBC_B,        &&SBC_C,        &&SBC_D,        &&SBC_E,        &&SBC_H,        &&SBC_L,        &&SBC_xHL,      &&SBC_A,        /* 0x98 */ \
+  &&AND_B,        &&AND_C,        &&AND_D,        &&AND_E,        &&AND_H,        &&AND_L,        &&AND_xHL,      &&AND_A,        /* 0xA0 */ \
+  &&XOR_B,        &&XOR_C,        &&XOR_D,        &&XOR_E,        &&XOR_H,        &&XOR_L,        &&XOR_xHL,      &&XOR_A,        /* 0xA8 */ \
+  &&OR_B,         &&OR_C,         &&OR_D,         &&OR_E,         &&OR_H,         &&OR_L,         &&OR_xHL,       &&OR_A,         /* 0xB0 */ \
+  &&CP_B,         &&CP_C,         &&CP_D,         &&CP_E,         &&CP_H,         &&CP_L,         &&CP_xHL,       &&CP_A,         /* 0xB8 */ \
+  &&RET_NZ,       &&POP_BC,       &&JP_NZ,        &&JP,           &&CALL_NZ,      &&PUSH_BC,      &&ADD_BYTE,     &&RST00,        /* 0xC0 */ \
+  &&RET_Z,        &&RET,          &&JP_Z,         &&PFX_CB,       &&CALL_Z,       &&CALL,         &&ADC_BYTE,     &&RST08,        /* 0xC8 */ \
+  &&RET_NC,       &&POP_DE,       &&JP_NC,        &&OUTA,         &&CALL_NC,      &&PUSH_DE,      &&SUB_BYTE,     &&RST10,        /* 0xD0 */ \
+  &&RET_C,        &&EXX,          &&JP_C,         &&INA,          &&CALL_C,       &&PFX_DD,       &&SBC_BYTE,     &&RST18,        /* 0xD8 */ \
+  &&RET_PO,       &&POP_HL,       &&JP_PO,        &&EX_HL_xSP,    &&CALL_PO,      &&PUSH_HL,      &&AND_BYTE,     &&RST20,        /* 0xE0 */ \
+  &&RET_PE,       &&LD_PC_HL,     &&JP_PE,        &&EX_DE_HL,     &&CALL_PE,      &&PFX_ED,       &&XOR_BYTE,     &&RST28,        /* 0xE8 */ \
+  &&RET_P,        &&POP_AF,       &&JP_P,         &&DI,           &&CALL_P,       &&PUSH_AF,      &&OR_BYTE,      &&RST30,        /* 0xF0 */ \
+  &&RET_M,        &&LD_SP_HL,     &&JP_M,         &&EI,           &&CALL_M,       &&PFX_FD,       &&CP_BYTE,      &&RST38         /* 0xF8 */ \
+}
+
+// CB prefix page
+#define THREADED_TABLE_CB \
+{ \
+  &&RLC_B,        &&RLC_C,        &&RLC_D,        &&RLC_E,        &&RLC_H,        &&RLC_L,        &&RLC_xHL,      &&RLC_A,        /* 0x00 */ \
+  &&RRC_B,        &&RRC_C,        &&RRC_D,        &&RRC_E,        &&RRC_H,        &&RRC_L,        &&RRC_xHL,      &&RRC_A,        /* 0x08 */ \
+  &&RL_B,         &&RL_C,         &&RL_D,         &&RL_E,         &&RL_H,         &&RL_L,         &&RL_xHL,       &&RL_A,         /* 0x10 */ \
+  &&RR_B,         &&RR_C,         &&RR_D,         &&RR_E,         &&RR_H,         &&RR_L,         &&RR_xHL,       &&RR_A,         /* 0x18 */ \
+  &&SLA_B,        &&SLA_C,        &&SLA_D,        &&SLA_E,        &&SLA_H,        &&SLA_L,        &&SLA_xHL,      &&SLA_A,        /* 0x20 */ \
+  &&SRA_B,        &&SRA_C,        &&SRA_D,        &&SRA_E,        &&SRA_H,        &&SRA_L,        &&SRA_xHL,      &&SRA_A,        /* 0x28 */ \
+  &&SLL_B,        &&SLL_C,        &&SLL_D,        &&SLL_E,        &&SLL_H,        &&SLL_L,        &&SLL_xHL,      &&SLL_A,        /* 0x30 */ \
+  &&SRL_B,        &&SRL_C,        &&SRL_D,        &&SRL_E,        &&SRL_H,        &&SRL_L,        &&SRL_xHL,      &&SRL_A,        /* 0x38 */ \
+  &&BIT0_B,       &&BIT0_C,       &&BIT0_D,       &&BIT0_E,       &&BIT0_H,       &&BIT0_L,       &&BIT0_xHL,     &&BIT0_A,       /* 0x40 */ \
+  &&BIT1_B,       &&BIT1_C,       &&BIT1_D,       &&BIT1_E,       &&BIT1_H,       &&BIT1_L,       &&BIT1_xHL,     &&BIT1_A,       /* 0x48 */ \
+  &&BIT2_B,       &&BIT2_C,       &&BIT2_D,       &&BIT2_E,       &&BIT2_H,       &&BIT2_L,       &&BIT2_xHL,     &&BIT2_A,       /* 0x50 */ \
+  &&BIT3_B,       &&BIT3_C,       &&BIT3_D,       &&BIT3_E,       &&BIT3_H,       &&BIT3_L,       &&BIT3_xHL,     &&BIT3_A,       /* 0x58 */ \
+  &&BIT4_B,       &&BIT4_C,       &&BIT4_D,       &&BIT4_E,       &&BIT4_H,       &&BIT4_L,       &&BIT4_xHL,     &&BIT4_A,       /* 0x60 */ \
+  &&BIT5_B,       &&BIT5_C,       &&BIT5_D,       &&BIT5_E,       &&BIT5_H,       &&BIT5_L,       &&BIT5_xHL,     &&BIT5_A,       /* 0x68 */ \
+  &&BIT6_B,       &&BIT6_C,       &&BIT6_D,       &&BIT6_E,       &&BIT6_H,       &&BIT6_L,       &&BIT6_xHL,     &&BIT6_A,       /* 0x70 */ \
+  &&BIT7_B,       &&BIT7_C,       &&BIT7_D,       &&BIT7_E,       &&BIT7_H,       &&BIT7_L,       &&BIT7_xHL,     &&BIT7_A,       /* 0x78 */ \
+  &&RES0_B,       &&RES0_C,       &&RES0_D,       &&RES0_E,       &&RES0_H,       &&RES0_L,       &&RES0_xHL,     &&RES0_A,       /* 0x80 */ \
+  &&RES1_B,       &&RES1_C,       &&RES1_D,       &&RES1_E,       &&RES1_H,       &&RES1_L,       &&RES1_xHL,     &&RES1_A,       /* 0x88 */ \
+  &&RES2_B,       &&RES2_C,       &&RES2_D,       &&RES2_E,       &&RES2_H,       &&RES2_L,       &&RES2_xHL,     &&RES2_A,       /* 0x90 */ \
+  &&RES3_B,       &&RES3_C,       &&RES3_D,       &&RES3_E,       &&RES3_H,       &&RES3_L,       &&RES3_xHL,     &&RES3_A,       /* 0x98 */ \
+  &&RES4_B,       &&RES4_C,       &&RES4_D,       &&RES4_E,       &&RES4_H,       &&RES4_L,       &&RES4_xHL,     &&RES4_A,       /* 0xA0 */ \
+  &&RES5_B,       &&RES5_C,       &&RES5_D,       &&RES5_E,       &&RES5_H,       &&RES5_L,       &&RES5_xHL,     &&RES5_A,       /* 0xA8 */ \
+  &&RES6_B,       &&RES6_C,       &&RES6_D,       &&RES6_E,       &&RES6_H,       &&RES6_L,       &&RES6_xHL,     &&RES6_A,       /* 0xB0 */ \
+  &&RES7_B,       &&RES7_C,       &&RES7_D,       &&RES7_E,       &&RES7_H,       &&RES7_L,       &&RES7_xHL,     &&RES7_A,       /* 0xB8 */ \
+  &&SET0_B,       &&SET0_C,       &&SET0_D,       &&SET0_E,       &&SET0_H,       &&SET0_L,       &&SET0_xHL,     &&SET0_A,       /* 0xC0 */ \
+  &&SET1_B,       &&SET1_C,       &&SET1_D,       &&SET1_E,       &&SET1_H,       &&SET1_L,       &&SET1_xHL,     &&SET1_A,       /* 0xC8 */ \
+  &&SET2_B,       &&SET2_C,       &&SET2_D,       &&SET2_E,       &&SET2_H,       &&SET2_L,       &&SET2_xHL,     &&SET2_A,       /* 0xD0 */ \
+  &&SET3_B,       &&SET3_C,       &&SET3_D,       &&SET3_E,       &&SET3_H,       &&SET3_L,       &&SET3_xHL,     &&SET3_A,       /* 0xD8 */ \
+  &&SET4_B,       &&SET4_C,       &&SET4_D,       &&SET4_E,       &&SET4_H,       &&SET4_L,       &&SET4_xHL,     &&SET4_A,       /* 0xE0 */ \
+  &&SET5_B,       &&SET5_C,       &&SET5_D,       &&SET5_E,       &&SET5_H,       &&SET5_L,       &&SET5_xHL,     &&SET5_A,       /* 0xE8 */ \
+  &&SET6_B,       &&SET6_C,       &&SET6_D,       &&SET6_E,       &&SET6_H,       &&SET6_L,       &&SET6_xHL,     &&SET6_A,       /* 0xF0 */ \
+  &&SET7_B,       &&SET7_C,       &&SET7_D,       &&SET7_E,       &&SET7_H,       &&SET7_L,       &&SET7_xHL,     &&SET7_A        /* 0xF8 */ \
+}
+
+// ED prefix page - anything not implemented in CodesED.h goes to ED_BadOp
+#define THREADED_TABLE_ED \
+{ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x00 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x08 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x10 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x18 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x20 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x28 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x30 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x38 */ \
+  &&IN_B_xC,      &&OUT_xC_B,     &&SBC_HL_BC,    &&LD_xWORDe_BC, &&NEG,          &&RETN,         &&IM_0,         &&LD_I_A,       /* 0x40 */ \
+  &&IN_C_xC,      &&OUT_xC_C,     &&ADC_HL_BC,    &&LD_BC_xWORDe, &&ED_BadOp,     &&RETI,         &&ED_BadOp,     &&LD_R_A,       /* 0x48 */ \
+  &&IN_D_xC,      &&OUT_xC_D,     &&SBC_HL_DE,    &&LD_xWORDe_DE, &&ED_BadOp,     &&ED_BadOp,     &&IM_1,         &&LD_A_I,       /* 0x50 */ \
+  &&IN_E_xC,      &&OUT_xC_E,     &&ADC_HL_DE,    &&LD_DE_xWORDe, &&ED_BadOp,     &&ED_BadOp,     &&IM_2,         &&LD_A_R,       /* 0x58 */ \
+  &&IN_H_xC,      &&OUT_xC_H,     &&SBC_HL_HL,    &&LD_xWORDe_HL, &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&RRD,          /* 0x60 */ \
+  &&IN_L_xC,      &&OUT_xC_L,     &&ADC_HL_HL,    &&LD_HL_xWORDe, &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&RLD,          /* 0x68 */ \
+  &&IN_F_xC,      &&OUT_xC_F,     &&SBC_HL_SP,    &&LD_xWORDe_SP, &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x70 */ \
+  &&IN_A_xC,      &&OUT_xC_A,     &&ADC_HL_SP,    &&LD_SP_xWORDe, &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x78 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x80 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x88 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x90 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0x98 */ \
+  &&LDI,          &&CPI,          &&INI,          &&OUTI,         &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xA0 */ \
+  &&LDD,          &&CPD,          &&IND,          &&OUTD,         &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xA8 */ \
+  &&LDIR,         &&CPIR,         &&INIR,         &&OTIR,         &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xB0 */ \
+  &&LDDR,         &&CPDR,         &&INDR,         &&OTDR,         &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xB8 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xC0 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xC8 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xD0 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xD8 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xE0 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_Repeat,    &&ED_BadOp,     &&ED_BadOp,     /* 0xE8 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     /* 0xF0 */ \
+  &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp,     &&ED_BadOp      /* 0xF8 */ \
+}
+
+// DD/FD prefix page - expanded once for IX and once for IY
+#define THREADED_TABLE_XX \
+{ \
+  &&NOP,          &&LD_BC_WORD,   &&LD_xBC_A,     &&INC_BC,       &&INC_B,        &&DEC_B,        &&LD_B_BYTE,    &&RLCA,         /* 0x00 */ \
+  &&EX_AF_AF,     &&ADD_HL_BC,    &&LD_A_xBC,     &&DEC_BC,       &&INC_C,        &&DEC_C,        &&LD_C_BYTE,    &&RRCA,         /* 0x08 */ \
+  &&XX_BadOp,     &&LD_DE_WORD,   &&LD_xDE_A,     &&INC_DE,       &&INC_D,        &&DEC_D,        &&LD_D_BYTE,    &&RLA,          /* 0x10 */ \
+  &&XX_BadOp,     &&ADD_HL_DE,    &&LD_A_xDE,     &&DEC_DE,       &&INC_E,        &&DEC_E,        &&LD_E_BYTE,    &&RRA,          /* 0x18 */ \
+  &&XX_BadOp,     &&LD_HL_WORD,   &&LD_xWORD_HL,  &&INC_HL,       &&INC_H,        &&DEC_H,        &&LD_H_BYTE,    &&XX_BadOp,     /* 0x20 */ \
+  &&XX_BadOp,     &&ADD_HL_HL,    &&LD_HL_xWORD,  &&DEC_HL,       &&INC_L,        &&DEC_L,        &&LD_L_BYTE,    &&CPL,          /* 0x28 */ \
+  &&XX_BadOp,     &&LD_SP_WORD,   &&LD_xWORD_A,   &&INC_SP,       &&INC_xHL,      &&DEC_xHL,      &&LD_xHL_BYTE,  &&SCF,          /* 0x30 */ \
+  &&XX_BadOp,     &&ADD_HL_SP,    &&LD_A_xWORD,   &&DEC_SP,       &&INC_A,        &&DEC_A,        &&LD_A_BYTE,    &&XX_BadOp,     /* 0x38 */ \
+  &&LD_B_B,       &&LD_B_C,       &&LD_B_D,       &&LD_B_E,       &&LD_B_H,       &&LD_B_L,       &&LD_B_xHL,     &&LD_B_A,       /* 0x40 */ \
+  &&LD_C_B,       &&LD_C_C,       &&LD_C_D,       &&LD_C_E,       &&LD_C_H,       &&LD_C_L,       &&LD_C_xHL,     &&LD_C_A,       /* 0x48 */ \
+  &&LD_D_B,       &&LD_D_C,       &&LD_D_D,       &&LD_D_E,       &&LD_D_H,       &&LD_D_L,       &&LD_D_xHL,     &&LD_D_A,       /* 0x50 */ \
+  &&LD_E_B,       &&LD_E_C,       &&LD_E_D,       &&LD_E_E,       &&LD_E_H,       &&LD_E_L,       &&LD_E_xHL,     &&LD_E_A,       /* 0x58 */ \
+  &&LD_H_B,       &&LD_H_C,       &&LD_H_D,       &&LD_H_E,       &&LD_H_H,       &&LD_H_L,       &&LD_H_xHL,     &&LD_H_A,       /* 0x60 */ \
+  &&LD_L_B,       &&LD_L_C,       &&LD_L_D,       &&LD_L_E,       &&LD_L_H,       &&LD_L_L,       &&LD_L_xHL,     &&LD_L_A,       /* 0x68 */ \
+  &&LD_xHL_B,     &&LD_xHL_C,     &&LD_xHL_D,     &&LD_xHL_E,     &&LD_xHL_H,     &&LD_xHL_L,     &&XX_BadOp,     &&LD_xHL_A,     /* 0x70 */ \
+  &&LD_A_B,       &&LD_A_C,       &&LD_A_D,       &&LD_A_E,       &&LD_A_H,       &&LD_A_L,       &&LD_A_xHL,     &&LD_A_A,       /* 0x78 */ \
+  &&ADD_B,        &&ADD_C,        &&ADD_D,        &&ADD_E,        &&ADD_H,        &&ADD_L,        &&ADD_xHL,      &&ADD_A,        /* 0x80 */ \
+  &&ADC_B,        &&ADC_C,        &&ADC_D,        &&ADC_E,        &&ADC_H,        &&ADC_L,        &&ADC_xHL,      &&ADC_A,        /* 0x88 */ \
+  &&SUB_B,        &&SUB_C,        &&SUB_D,        &&SUB_E,        &&SUB_H,        &&SUB_L,        &&SUB_xHL,      &&SUB_A,        /* 0x90 */ \
+  &&SBC_B,        &&SBC_C,        &&SBC_D,        &&SBC_E,        &&SBC_H,        &&SBC_L,        &&SBC_xHL,      &&SBC_A,        /* 0x98 */ \
+  &&AND_B,        &&AND_C,        &&AND_D,        &&AND_E,        &&AND_H,        &&AND_L,        &&AND_xHL,      &&AND_A,        /* 0xA0 */ \
+  &&XOR_B,        &&XOR_C,        &&XOR_D,        &&XOR_E,        &&XOR_H,        &&XOR_L,        &&XOR_xHL,      &&XOR_A,        /* 0xA8 */ \
+  &&OR_B,         &&OR_C,         &&OR_D,         &&OR_E,         &&OR_H,         &&OR_L,         &&OR_xHL,       &&OR_A,         /* 0xB0 */ \
+  &&CP_B,         &&CP_C,         &&CP_D,         &&CP_E,         &&CP_H,         &&CP_L,         &&CP_xHL,       &&CP_A,         /* 0xB8 */ \
+  &&XX_BadOp,     &&POP_BC,       &&XX_BadOp,     &&XX_BadOp,     &&XX_BadOp,     &&PUSH_BC,      &&ADD_BYTE,     &&RST00,        /* 0xC0 */ \
+  &&XX_BadOp,     &&XX_BadOp,     &&XX_BadOp,     &&XX_PfxCB,     &&XX_BadOp,     &&XX_BadOp,     &&ADC_BYTE,     &&RST08,        /* 0xC8 */ \
+  &&XX_BadOp,     &&POP_DE,       &&XX_BadOp,     &&OUTA,         &&XX_BadOp,     &&PUSH_DE,      &&SUB_BYTE,     &&RST10,        /* 0xD0 */ \
+  &&XX_BadOp,     &&XX_BadOp,     &&XX_BadOp,     &&INA,          &&XX_BadOp,     &&XX_Repeat,    &&SBC_BYTE,     &&RST18,        /* 0xD8 */ \
+  &&XX_BadOp,     &&POP_HL,       &&XX_BadOp,     &&EX_HL_xSP,    &&XX_BadOp,     &&PUSH_HL,      &&AND_BYTE,     &&RST20,        /* 0xE0 */ \
+  &&XX_BadOp,     &&LD_PC_HL,     &&XX_BadOp,     &&EX_DE_HL,     &&XX_BadOp,     &&XX_BadOp,     &&XOR_BYTE,     &&RST28,        /* 0xE8 */ \
+  &&XX_BadOp,     &&POP_AF,       &&XX_BadOp,     &&XX_BadOp,     &&XX_BadOp,     &&PUSH_AF,      &&OR_BYTE,      &&RST30,        /* 0xF0 */ \
+  &&XX_BadOp,     &&LD_SP_HL,     &&XX_BadOp,     &&XX_BadOp,     &&XX_BadOp,     &&XX_Repeat,    &&CP_BYTE,      &&RST38         /* 0xF8 */ \
+}
+
+// DDCB/FDCB prefix page - expanded once for IX and once for IY
+#define THREADED_TABLE_XCB \
+{ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RLC_xHL,      &&XCB_BadOp,    /* 0x00 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RRC_xHL,      &&XCB_BadOp,    /* 0x08 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RL_xHL,       &&XCB_BadOp,    /* 0x10 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RR_xHL,       &&XCB_BadOp,    /* 0x18 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SLA_xHL,      &&XCB_BadOp,    /* 0x20 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SRA_xHL,      &&XCB_BadOp,    /* 0x28 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SLL_xHL,      &&XCB_BadOp,    /* 0x30 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SRL_xHL,      &&XCB_BadOp,    /* 0x38 */ \
+  &&BIT0_B,       &&BIT0_C,       &&BIT0_D,       &&BIT0_E,       &&BIT0_H,       &&BIT0_L,       &&BIT0_xHL,     &&BIT0_A,       /* 0x40 */ \
+  &&BIT1_B,       &&BIT1_C,       &&BIT1_D,       &&BIT1_E,       &&BIT1_H,       &&BIT1_L,       &&BIT1_xHL,     &&BIT1_A,       /* 0x48 */ \
+  &&BIT2_B,       &&BIT2_C,       &&BIT2_D,       &&BIT2_E,       &&BIT2_H,       &&BIT2_L,       &&BIT2_xHL,     &&BIT2_A,       /* 0x50 */ \
+  &&BIT3_B,       &&BIT3_C,       &&BIT3_D,       &&BIT3_E,       &&BIT3_H,       &&BIT3_L,       &&BIT3_xHL,     &&BIT3_A,       /* 0x58 */ \
+  &&BIT4_B,       &&BIT4_C,       &&BIT4_D,       &&BIT4_E,       &&BIT4_H,       &&BIT4_L,       &&BIT4_xHL,     &&BIT4_A,       /* 0x60 */ \
+  &&BIT5_B,       &&BIT5_C,       &&BIT5_D,       &&BIT5_E,       &&BIT5_H,       &&BIT5_L,       &&BIT5_xHL,     &&BIT5_A,       /* 0x68 */ \
+  &&BIT6_B,       &&BIT6_C,       &&BIT6_D,       &&BIT6_E,       &&BIT6_H,       &&BIT6_L,       &&BIT6_xHL,     &&BIT6_A,       /* 0x70 */ \
+  &&BIT7_B,       &&BIT7_C,       &&BIT7_D,       &&BIT7_E,       &&BIT7_H,       &&BIT7_L,       &&BIT7_xHL,     &&BIT7_A,       /* 0x78 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES0_xHL,     &&XCB_BadOp,    /* 0x80 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES1_xHL,     &&XCB_BadOp,    /* 0x88 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES2_xHL,     &&XCB_BadOp,    /* 0x90 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES3_xHL,     &&XCB_BadOp,    /* 0x98 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES4_xHL,     &&XCB_BadOp,    /* 0xA0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES5_xHL,     &&XCB_BadOp,    /* 0xA8 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES6_xHL,     &&XCB_BadOp,    /* 0xB0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&RES7_xHL,     &&XCB_BadOp,    /* 0xB8 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET0_xHL,     &&XCB_BadOp,    /* 0xC0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET1_xHL,     &&XCB_BadOp,    /* 0xC8 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET2_xHL,     &&XCB_BadOp,    /* 0xD0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET3_xHL,     &&XCB_BadOp,    /* 0xD8 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET4_xHL,     &&XCB_BadOp,    /* 0xE0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET5_xHL,     &&XCB_BadOp,    /* 0xE8 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET6_xHL,     &&XCB_BadOp,    /* 0xF0 */ \
+  &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&XCB_BadOp,    &&SET7_xHL,     &&XCB_BadOp     /* 0xF8 */ \
+}
+
+// The DD and FD pages re-use the main page opcode names so their labels are made block-local
+#define THREADED_LABELS_XX \
+  __label__ ADD_B; __label__ ADD_C; __label__ ADD_D; __label__ ADD_E; __label__ ADD_H; __label__ ADD_L;                              \
+  __label__ ADD_A; __label__ ADD_xHL; __label__ ADD_BYTE; __label__ SUB_B; __label__ SUB_C; __label__ SUB_D;                         \
+  __label__ SUB_E; __label__ SUB_H; __label__ SUB_L; __label__ SUB_A; __label__ SUB_xHL; __label__ SUB_BYTE;                         \
+  __label__ AND_B; __label__ AND_C; __label__ AND_D; __label__ AND_E; __label__ AND_H; __label__ AND_L;                              \
+  __label__ AND_A; __label__ AND_xHL; __label__ AND_BYTE; __label__ OR_B; __label__ OR_C; __label__ OR_D;                            \
+  __label__ OR_E; __label__ OR_H; __label__ OR_L; __label__ OR_A; __label__ OR_xHL; __label__ OR_BYTE;                               \
+  __label__ ADC_B; __label__ ADC_C; __label__ ADC_D; __label__ ADC_E; __label__ ADC_H; __label__ ADC_L;                              \
+  __label__ ADC_A; __label__ ADC_xHL; __label__ ADC_BYTE; __label__ SBC_B; __label__ SBC_C; __label__ SBC_D;                         \
+  __label__ SBC_E; __label__ SBC_H; __label__ SBC_L; __label__ SBC_A; __label__ SBC_xHL; __label__ SBC_BYTE;                         \
+  __label__ XOR_B; __label__ XOR_C; __label__ XOR_D; __label__ XOR_E; __label__ XOR_H; __label__ XOR_L;                              \
+  __label__ XOR_A; __label__ XOR_xHL; __label__ XOR_BYTE; __label__ CP_B; __label__ CP_C; __label__ CP_D;                            \
+  __label__ CP_E; __label__ CP_H; __label__ CP_L; __label__ CP_A; __label__ CP_xHL; __label__ CP_BYTE;                               \
+  __label__ LD_BC_WORD; __label__ LD_DE_WORD; __label__ LD_HL_WORD; __label__ LD_SP_WORD; __label__ LD_PC_HL; __label__ LD_SP_HL;    \
+  __label__ LD_A_xBC; __label__ LD_A_xDE; __label__ ADD_HL_BC; __label__ ADD_HL_DE; __label__ ADD_HL_HL; __label__ ADD_HL_SP;        \
+  __label__ DEC_BC; __label__ DEC_DE; __label__ DEC_HL; __label__ DEC_SP; __label__ INC_BC; __label__ INC_DE;                        \
+  __label__ INC_HL; __label__ INC_SP; __label__ DEC_B; __label__ DEC_C; __label__ DEC_D; __label__ DEC_E;                            \
+  __label__ DEC_H; __label__ DEC_L; __label__ DEC_A; __label__ DEC_xHL; __label__ INC_B; __label__ INC_C;                            \
+  __label__ INC_D; __label__ INC_E; __label__ INC_H; __label__ INC_L; __label__ INC_A; __label__ INC_xHL;                            \
+  __label__ RLCA; __label__ RLA; __label__ RRCA; __label__ RRA; __label__ RST00; __label__ RST08;                                    \
+  __label__ RST10; __label__ RST18; __label__ RST20; __label__ RST28; __label__ RST30; __label__ RST38;                              \
+  __label__ PUSH_BC; __label__ PUSH_DE; __label__ PUSH_HL; __label__ PUSH_AF; __label__ POP_BC; __label__ POP_DE;                    \
+  __label__ POP_HL; __label__ POP_AF; __label__ SCF; __label__ CPL; __label__ NOP; __label__ OUTA;                                   \
+  __label__ INA; __label__ EX_DE_HL; __label__ EX_AF_AF; __label__ LD_B_B; __label__ LD_C_B; __label__ LD_D_B;                       \
+  __label__ LD_E_B; __label__ LD_H_B; __label__ LD_L_B; __label__ LD_A_B; __label__ LD_xHL_B; __label__ LD_B_C;                      \
+  __label__ LD_C_C; __label__ LD_D_C; __label__ LD_E_C; __label__ LD_H_C; __label__ LD_L_C; __label__ LD_A_C;                        \
+  __label__ LD_xHL_C; __label__ LD_B_D; __label__ LD_C_D; __label__ LD_D_D; __label__ LD_E_D; __label__ LD_H_D;                      \
+  __label__ LD_L_D; __label__ LD_A_D; __label__ LD_xHL_D; __label__ LD_B_E; __label__ LD_C_E; __label__ LD_D_E;                      \
+  __label__ LD_E_E; __label__ LD_H_E; __label__ LD_L_E; __label__ LD_A_E; __label__ LD_xHL_E; __label__ LD_B_H;                      \
+  __label__ LD_C_H; __label__ LD_D_H; __label__ LD_E_H; __label__ LD_H_H; __label__ LD_L_H; __label__ LD_A_H;                        \
+  __label__ LD_xHL_H; __label__ LD_B_L; __label__ LD_C_L; __label__ LD_D_L; __label__ LD_E_L; __label__ LD_H_L;                      \
+  __label__ LD_L_L; __label__ LD_A_L; __label__ LD_xHL_L; __label__ LD_B_A; __label__ LD_C_A; __label__ LD_D_A;                      \
+  __label__ LD_E_A; __label__ LD_H_A; __label__ LD_L_A; __label__ LD_A_A; __label__ LD_xHL_A; __label__ LD_xBC_A;                    \
+  __label__ LD_xDE_A; __label__ LD_B_xHL; __label__ LD_C_xHL; __label__ LD_D_xHL; __label__ LD_E_xHL; __label__ LD_H_xHL;            \
+  __label__ LD_L_xHL; __label__ LD_A_xHL; __label__ LD_B_BYTE; __label__ LD_C_BYTE; __label__ LD_D_BYTE; __label__ LD_E_BYTE;        \
+  __label__ LD_H_BYTE; __label__ LD_L_BYTE; __label__ LD_A_BYTE; __label__ LD_xHL_BYTE; __label__ LD_xWORD_HL; __label__ LD_HL_xWORD; \
+  __label__ LD_A_xWORD; __label__ LD_xWORD_A; __label__ EX_HL_xSP; __label__ XX_BadOp; __label__ XX_Repeat; __label__ XX_PfxCB;
+
+// Likewise the DDCB and FDCB pages re-use the CB page opcode names
+#define THREADED_LABELS_XCB \
+  __label__ RLC_xHL; __label__ RRC_xHL; __label__ RL_xHL; __label__ RR_xHL; __label__ SLA_xHL; __label__ SRA_xHL;                    \
+  __label__ SLL_xHL; __label__ SRL_xHL; __label__ BIT0_B; __label__ BIT0_C; __label__ BIT0_D; __label__ BIT0_E;                      \
+  __label__ BIT0_H; __label__ BIT0_L; __label__ BIT0_A; __label__ BIT0_xHL; __label__ BIT1_B; __label__ BIT1_C;                      \
+  __label__ BIT1_D; __label__ BIT1_E; __label__ BIT1_H; __label__ BIT1_L; __label__ BIT1_A; __label__ BIT1_xHL;                      \
+  __label__ BIT2_B; __label__ BIT2_C; __label__ BIT2_D; __label__ BIT2_E; __label__ BIT2_H; __label__ BIT2_L;                        \
+  __label__ BIT2_A; __label__ BIT2_xHL; __label__ BIT3_B; __label__ BIT3_C; __label__ BIT3_D; __label__ BIT3_E;                      \
+  __label__ BIT3_H; __label__ BIT3_L; __label__ BIT3_A; __label__ BIT3_xHL; __label__ BIT4_B; __label__ BIT4_C;                      \
+  __label__ BIT4_D; __label__ BIT4_E; __label__ BIT4_H; __label__ BIT4_L; __label__ BIT4_A; __label__ BIT4_xHL;                      \
+  __label__ BIT5_B; __label__ BIT5_C; __label__ BIT5_D; __label__ BIT5_E; __label__ BIT5_H; __label__ BIT5_L;                        \
+  __label__ BIT5_A; __label__ BIT5_xHL; __label__ BIT6_B; __label__ BIT6_C; __label__ BIT6_D; __label__ BIT6_E;                      \
+  __label__ BIT6_H; __label__ BIT6_L; __label__ BIT6_A; __label__ BIT6_xHL; __label__ BIT7_B; __label__ BIT7_C;                      \
+  __label__ BIT7_D; __label__ BIT7_E; __label__ BIT7_H; __label__ BIT7_L; __label__ BIT7_A; __label__ BIT7_xHL;                      \
+  __label__ RES0_xHL; __label__ RES1_xHL; __label__ RES2_xHL; __label__ RES3_xHL; __label__ RES4_xHL; __label__ RES5_xHL;            \
+  __label__ RES6_xHL; __label__ RES7_xHL; __label__ SET0_xHL; __label__ SET1_xHL; __label__ SET2_xHL; __label__ SET3_xHL;            \
+  __label__ SET4_xHL; __label__ SET5_xHL; __label__ SET6_xHL; __label__ SET7_xHL; __label__ XCB_BadOp;
@@ -26,14 +26,23 @@
 #include "Z80.h"
 #include "Tables.h"
 #include <stdio.h>
+#include <string.h>
 #include "../../../printf.h"
 
 extern Z80 CPU;
 
 extern u32 debug[];
 extern u32 DX,DY;
-extern u8 zx_ScreenRendering, zx_contend_delay, zx_128k_mode, portFD;
+extern u8 zx_contend_table[4];
+extern u8 zx_ula_contend[256];
+extern u32 zx_contend_base;
+extern u8 zx_screen_slot[4];
+extern u8 zx_dirty_rows[192];
+extern u8 zx_beam_render;
+extern void zx_beam_log_write(u32 tstates, word offset, byte value);
 extern void EI_Enable(void);
+extern u8 zx_idle_loop(word start, word jr);
+extern u32 zx_idle_skipped;
 
 #define INLINE static inline
 
@@ -63,12 +72,60 @@ inline byte OpZ80(word A)
     return *(MemoryMap[(A)>>14] + ((A)&0x3FFF));
 }
 
-#define RdZ80 OpZ80 // Nothing unique about a memory read - same as an OpZ80 opcode fetch
+// -------------------------------------------------------------------------------------------
+// Memory contention for an access to address A. The zx_contend_table[] is a mask for the
+// 16K slot (all zeros when the ULA isn't fetching screen data) and zx_ula_contend[] holds
+// the real ULA delay for where we are on the scanline. No branching - just two table loads.
+// See zx_contend_rebuild() in spectrum.c
+// -------------------------------------------------------------------------------------------
+#define CONTEND(A) CPU.TStates += (zx_contend_table[(A)>>14] & zx_ula_contend[(u8)(CPU.TStates - zx_contend_base)])
+
+// -------------------------------------------------------------------------------------------
+// A data read is the same as an opcode fetch except that it is subject to memory contention.
+// -------------------------------------------------------------------------------------------
+INLINE byte RdZ80(word A)
+{
+    CONTEND(A);
+    return *(MemoryMap[(A)>>14] + ((A)&0x3FFF));
+}
+
+// -------------------------------------------------------------------------------------------
+// A write that changes the displayed screen page marks the pixel row (or for an attribute,
+// the 8 rows of that character row) so the renderer knows to redraw it. See zx_dirty_rows[].
+// -------------------------------------------------------------------------------------------
+INLINE void ScreenDirtyZ80(word offset)
+{
+    if (offset < 0x1800) zx_dirty_rows[((offset>>8)&0x07) | ((offset>>2)&0x38) | ((offset>>5)&0xC0)] = 0xFF;
+    else
+    {
+        u32 *rows = (u32*)&zx_dirty_rows[((offset-0x1800)>>5)<<3];
+        rows[0] = 0xFFFFFFFF; rows[1] = 0xFFFFFFFF;
+    }
+}
 
 // -------------------------------------------------------------------------------------------
 // The only extra protection we have in writes is to ensure we don't write into the ROM area.
+// Writes are contended just like reads (the ROM slot never has a penalty in the table).
+// The ZEXDOC/ZEXALL harness (host/zex_test.c) runs CP/M programs which need RAM everywhere.
 // -------------------------------------------------------------------------------------------
-inline void WrZ80(word A, byte value)   {if (A & 0xC000) *(MemoryMap[(A)>>14] + ((A)&0x3FFF))=value;}
+#ifdef ZEXALL_TEST
+INLINE void WrZ80(word A, byte value)   {CONTEND(A); *(MemoryMap[(A)>>14] + ((A)&0x3FFF))=value;}
+#else
+INLINE void WrZ80(word A, byte value)
+{
+    CONTEND(A);
+    if (A & 0xC000)
+    {
+        byte *p = MemoryMap[(A)>>14] + ((A)&0x3FFF);
+        if (zx_screen_slot[(A)>>14] && (((A)&0x3FFF) < 0x1B00) && (*p != value))
+        {
+            ScreenDirtyZ80((A)&0x3FFF);
+            if (zx_beam_render) zx_beam_log_write(CPU.TStates, (A)&0x3FFF, value);
+        }
+        *p = value;
+    }
+}
+#endif
 
 // -------------------------------------------------------------------
 // And these two macros will give us access to the Z80 I/O ports...
@@ -128,7 +185,7 @@ inline void WrZ80(word A, byte value)   {if (A & 0xC000) *(MemoryMap[(A)>>14] +
 #define M_RES(Bit,Rg) Rg&=~(1<<Bit)
 
 #define M_POP(Rg)      \
-  CPU.Rg.B.l=OpZ80(CPU.SP.W++);CPU.Rg.B.h=OpZ80(CPU.SP.W++)
+  CPU.Rg.B.l=RdZ80(CPU.SP.W++);CPU.Rg.B.h=RdZ80(CPU.SP.W++)
 #define M_PUSH(Rg)     \
   WrZ80(--CPU.SP.W,CPU.Rg.B.h);WrZ80(--CPU.SP.W,CPU.Rg.B.l)
 
@@ -140,7 +197,22 @@ inline void WrZ80(word A, byte value)   {if (A & 0xC000) *(MemoryMap[(A)>>14] +
 
 #define M_JP  CPU.PC.W = (u32)OpZ80(CPU.PC.W) | ((u32)OpZ80(CPU.PC.W+1) << 8);
 #define M_JR  CPU.PC.W+=(offset)OpZ80(CPU.PC.W)+1;JumpZ80(CPU.PC.W)
-#define M_RET CPU.PC.B.l=OpZ80(CPU.SP.W++);CPU.PC.B.h=OpZ80(CPU.SP.W++);JumpZ80(CPU.PC.W)
+
+// ------------------------------------------------------------------------------------
+// A taken JR that goes a short way backwards may be an idle loop waiting on the frame
+// interrupt. If so, skip ahead to the end of this run just like HALT does below.
+// ------------------------------------------------------------------------------------
+#define M_JR_IDLE                                                         \
+  J.W=CPU.PC.W-1; M_JR;                                                   \
+  if (((word)(J.W-CPU.PC.W) < 16) && (CPU.TStates < RunToCycles))         \
+  {                                                                       \
+      if (zx_idle_loop(CPU.PC.W, J.W))                                    \
+      {                                                                   \
+          zx_idle_skipped += RunToCycles - CPU.TStates;                   \
+          CPU.TStates = RunToCycles;                                      \
+      }                                                                   \
+  }
+#define M_RET CPU.PC.B.l=RdZ80(CPU.SP.W++);CPU.PC.B.h=RdZ80(CPU.SP.W++);JumpZ80(CPU.PC.W)
 
 #define M_RST(Ad)      \
   WrZ80(--CPU.SP.W,CPU.PC.B.h);WrZ80(--CPU.SP.W,CPU.PC.B.l);CPU.PC.W=Ad;JumpZ80(Ad)
@@ -191,6 +263,43 @@ inline void WrZ80(word A, byte value)   {if (A & 0xC000) *(MemoryMap[(A)>>14] +
 #define M_OR(Rg)  CPU.AF.B.h|=Rg;CPU.AF.B.l=PZSTable[CPU.AF.B.h]
 #define M_XOR(Rg) CPU.AF.B.h^=Rg;CPU.AF.B.l=PZSTable[CPU.AF.B.h]
 
+#ifdef Z80_PROFILE
+// ------------------------------------------------------------------------------
+// Opcode and PC hot-spot profiler. Every opcode fetch bumps a counter for the
+// page it was fetched from and the main page fetches also bump the 256-byte
+// bucket for where the PC was. Kept out of DTCM as it's 8K of counters...
+// ------------------------------------------------------------------------------
+u32 Z80_ProfOps[Z80_PROF_PAGES][256];
+u32 Z80_ProfPC[256];
+
+#define PROF_OP(Page,I)   Z80_ProfOps[Page][I]++
+#define PROF_PC()         Z80_ProfPC[(word)(CPU.PC.W-1)>>8]++
+
+void ResetProfileZ80(void)
+{
+  memset(Z80_ProfOps, 0x00, sizeof(Z80_ProfOps));
+  memset(Z80_ProfPC, 0x00, sizeof(Z80_ProfPC));
+}
+
+int TopProfileZ80(const u32 *Counts,int Size,int N,u16 *Idx)
+{
+  int Found=0;
+
+  // Simple insertion into the sorted top-N list - only run on demand so no need to be clever
+  for (int i=0; i<Size; i++)
+  {
+      if (!Counts[i]) continue;
+      int j = (Found < N) ? Found++ : N;
+      while (j && (Counts[Idx[j-1]] < Counts[i])) {if (j<N) Idx[j]=Idx[j-1]; j--;}
+      if (j<N) Idx[j]=i;
+  }
+  return Found;
+}
+#else
+#define PROF_OP(Page,I)
+#define PROF_PC()
+#endif
+
 #define M_IN(Rg)        \
   Rg=InZ80(CPU.BC.W);  \
   CPU.AF.B.l=PZSTable[Rg]|(CPU.AF.B.l&C_FLAG)
@@ -339,6 +448,82 @@ enum CodesED
   DB_F8,    DB_F9,      DB_FA,      DB_FB,          DB_FC,      DB_FD,  DB_FE,  DB_FF
 };
 
+// ------------------------------------------------------------------------------------
+// The block repeat instructions (LDIR, CPIR, INIR, OTIR and friends) used to rewind the
+// PC and come back around through the main loop for every single byte. Instead we keep
+// repeating right in the handler until the block is done or we reach the next cycle
+// boundary (RunToCycles). ED_MORE() charges each repeat exactly what another trip
+// through the main loop would have: contention on the ED fetch, 21 T-states and two
+// M1 cycles worth of R register.
+// ------------------------------------------------------------------------------------
+#define ED_MORE() ((CPU.TStates < RunToCycles) ? (CONTEND((word)(CPU.PC.W-2)), CPU.TStates += 21, CPU.R += 2, 1) : 0)
+
+// ------------------------------------------------------------------------------------
+// LDIR (step=1) and LDDR (step=-1). The first byte has already been paid for by the
+// opcode fetch. When none of the PC, HL or DE slots are contended (which is always the
+// case when the screen isn't being drawn) we move a whole run of bytes at once - byte by
+// byte in the direction of travel so overlapping fills work just as on the real Z80.
+// A run stops at any 16K page edge so the MemoryMap[] is honoured and we never take the
+// fast path when writing into the ROM slot - WrZ80() handles that one byte at a time.
+// Returns with BC=0 if the block move is complete.
+// ------------------------------------------------------------------------------------
+INLINE void BlockMove(int step, u32 RunToCycles)
+{
+  do
+  {
+      u32 n = 1;
+
+      if ((CPU.DE.W & 0xC000) && !(zx_contend_table[(word)(CPU.PC.W-2)>>14] | zx_contend_table[CPU.HL.W>>14] | zx_contend_table[CPU.DE.W>>14]))
+      {
+          // How many bytes until HL or DE cross into another 16K page or BC runs out...
+          u32 hl_room = (step > 0) ? (0x4000 - (CPU.HL.W & 0x3FFF)) : ((CPU.HL.W & 0x3FFF) + 1);
+          u32 de_room = (step > 0) ? (0x4000 - (CPU.DE.W & 0x3FFF)) : ((CPU.DE.W & 0x3FFF) + 1);
+          n = (CPU.BC.W ? CPU.BC.W : 0x10000);
+          if (hl_room < n) n = hl_room;
+          if (de_room < n) n = de_room;
+
+          // And how many more repeats will start before we reach the cycle boundary
+          u32 more = (CPU.TStates < RunToCycles) ? ((RunToCycles - CPU.TStates + 20) / 21) : 0;
+          if (more + 1 < n) n = more + 1;
+
+          // Moving into the displayed screen page - mark every row we touch for redraw
+          if (zx_screen_slot[CPU.DE.W>>14])
+          {
+              word offset = CPU.DE.W & 0x3FFF;
+              for (u32 i=0; i<n; i++, offset += step) if (offset < 0x1B00) ScreenDirtyZ80(offset);
+          }
+
+          u8 *src = MemoryMap[CPU.HL.W>>14] + (CPU.HL.W & 0x3FFF);
+          u8 *dst = MemoryMap[CPU.DE.W>>14] + (CPU.DE.W & 0x3FFF);
+          for (u32 i=0; i<n; i++)
+          {
+              *dst = *src;
+              dst += step; src += step;
+          }
+
+          // And when rendering by frame, every byte is logged at the T-state it would be written
+          if (zx_beam_render && zx_screen_slot[CPU.DE.W>>14])
+          {
+              u8 *page = MemoryMap[CPU.DE.W>>14];
+              word offset = CPU.DE.W & 0x3FFF;
+              for (u32 i=0; i<n; i++, offset += step) if (offset < 0x1B00) zx_beam_log_write(CPU.TStates + 21*i, offset, page[offset]);
+          }
+
+          CPU.TStates += 21 * (n-1);
+          CPU.R += 2 * (n-1);
+      }
+      else
+      {
+          WrZ80(CPU.DE.W, RdZ80(CPU.HL.W));
+      }
+
+      CPU.HL.W += step * n;
+      CPU.DE.W += step * n;
+      CPU.BC.W -= n;
+  }
+  while (CPU.BC.W && ED_MORE());
+}
+
 extern void Trap_Bad_Ops(char *, byte, word);
 
 /** ResetZ80() ***********************************************/
@@ -452,6 +637,7 @@ static void CodesCB_Speccy(void)
   /* Read opcode and count cycles */
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesCB[I];
+  PROF_OP(Z80_PROF_CB,I);
 
   /* R register incremented on each M1 cycle */
   INCR(1);
@@ -474,6 +660,7 @@ static void CodesDDCB_Speccy(void)
   J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesXXCB[I];
+  PROF_OP(Z80_PROF_DDCB,I);
 
   switch(I)
   {
@@ -494,6 +681,7 @@ static void CodesFDCB_Speccy(void)
   J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesXXCB[I];
+  PROF_OP(Z80_PROF_FDCB,I);
 
   switch(I)
   {
@@ -504,7 +692,7 @@ static void CodesFDCB_Speccy(void)
 #undef XX
 }
 
-ITCM_CODE static void CodesED_Speccy(void)
+ITCM_CODE static void CodesED_Speccy(u32 RunToCycles)
 {
   register byte I;
   register pair J;
@@ -512,6 +700,7 @@ ITCM_CODE static void CodesED_Speccy(void)
   /* Read opcode and count cycles */
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesED[I];
+  PROF_OP(Z80_PROF_ED,I);
 
   /* R register incremented on each M1 cycle */
   INCR(1);
@@ -535,6 +724,7 @@ static void CodesDD_Speccy(void)
   /* Read opcode and count cycles */
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesXX[I];
+  PROF_OP(Z80_PROF_DD,I);
 
   /* R register incremented on each M1 cycle */
   INCR(1);
@@ -562,6 +752,7 @@ static void CodesFD_Speccy(void)
   /* Read opcode and count cycles */
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += CyclesXX[I];
+  PROF_OP(Z80_PROF_FD,I);
 
   /* R register incremented on each M1 cycle */
   INCR(1);
@@ -595,6 +786,7 @@ void ExecOneInstruction(void)
 
   I=OpZ80(CPU.PC.W++);
   CPU.TStates += Cycles_NoM1Wait[I];
+  PROF_OP(Z80_PROF_MAIN,I); PROF_PC();
 
   /* R register incremented on each M1 cycle */
   INCR(1);
@@ -604,7 +796,7 @@ void ExecOneInstruction(void)
   {
 #include "Codes.h"
     case PFX_CB: CodesCB_Speccy();break;
-    case PFX_ED: CodesED_Speccy();break;
+    case PFX_ED: CodesED_Speccy(RunToCycles);break;
     case PFX_FD: CodesFD_Speccy();break;
     case PFX_DD: CodesDD_Speccy();break;
   }
@@ -626,6 +818,31 @@ void EI_Enable(void)
    }
 }
 
+#if defined(Z80_ASM)
+#if defined(Z80_THREADED) || defined(Z80_PROFILE)
+#error "Z80_ASM replaces the C main loop and cannot be combined with Z80_THREADED or Z80_PROFILE"
+#endif
+// -----------------------------------------------------------------------------------
+// The main loop is the hand-written ARM core in armz80/ArmZ80.s which keeps PC, SP,
+// A, F and the cycle counter in registers. It only comes back here for the opcodes
+// it doesn't handle itself - the CB/DD/ED/FD prefixes, DAA, EI and the port I/O.
+// By then the opcode has been fetched and counted and R has been bumped so we just
+// need to interpret it exactly as ExecZ80_Speccy() below would have.
+// -----------------------------------------------------------------------------------
+ITCM_CODE void ExecOpcodeZ80(byte I, u32 RunToCycles)
+{
+  register pair J;
+
+  switch(I)
+  {
+#include "Codes.h"
+    case PFX_CB: CodesCB_Speccy();break;
+    case PFX_ED: CodesED_Speccy(RunToCycles);break;
+    case PFX_FD: CodesFD_Speccy();break;
+    case PFX_DD: CodesDD_Speccy();break;
+  }
+}
+#elif !defined(Z80_THREADED)
 // -----------------------------------------------------------------------------------
 // The main Z80 instruction loop. We put this 15K chunk into fast memory as we 
 // want to make the Z80 run as quickly as possible - this is the heart of the system.
@@ -634,35 +851,19 @@ ITCM_CODE void ExecZ80_Speccy(u32 RunToCycles)
 {
   register byte I;
   register pair J;
-  u8 render = zx_ScreenRendering;   // Slightly faster access from stack
-  u8 delay = zx_contend_delay;      // Slightly faster access from stack
 
   while (CPU.TStates < RunToCycles)
   {
       // ----------------------------------------------------------------------------------------
-      // If we are in contended memory - add penalty. This is not cycle accurate but we want to
-      // at least make an attempt to get closer on the cycle timing. So we simply use an 'average'
-      // penalty of 4 cycles if we are in contended memory while the screen is rendering. It's
-      // rough but gets us close enough to play games. We can improve this later...
+      // If we are in contended memory - add penalty. The slot mask is rebuilt on bank switches
+      // and zeroed when the screen isn't rendering and the delay comes from the ULA pattern for
+      // where we are on the scanline. We apply it once at the opcode fetch which is close enough.
       // ----------------------------------------------------------------------------------------
-      if (render)
-      {
-          if (CPU.PC.W & 0x4000) // Either 0x4000 or 0xC000
-          {
-              if (CPU.PC.W & 0x8000) // Must be 0xC000
-              {
-                  // For the ZX 128K bank, we contend if the bank is odd (1,3,5,7)
-                  if (zx_128k_mode && (portFD & 1)) CPU.TStates += delay;
-              }
-              else // Must be 0x4000 - we contend on any video access (both 48K and 128K)
-              {
-                  CPU.TStates += delay;
-              }              
-          }
-      }
+      CONTEND(CPU.PC.W);
 
       I=OpZ80(CPU.PC.W++);
       CPU.TStates += Cycles_NoM1Wait[I];
+      PROF_OP(Z80_PROF_MAIN,I); PROF_PC();
 
       /* R register incremented on each M1 cycle */
       INCR(1);
@@ -672,9 +873,162 @@ ITCM_CODE void ExecZ80_Speccy(u32 RunToCycles)
       {
 #include "Codes.h"
         case PFX_CB: CodesCB_Speccy();break;
-        case PFX_ED: CodesED_Speccy();break;
+        case PFX_ED: CodesED_Speccy(RunToCycles);break;
         case PFX_FD: CodesFD_Speccy();break;
         case PFX_DD: CodesDD_Speccy();break;
       }
   }
 }
+#else
+// -----------------------------------------------------------------------------------
+// The threaded (computed-goto) version of the main Z80 instruction loop. Rather than
+// one big switch() with a single shared dispatch point, every handler ends with its
+// own copy of the fetch/contention/R-increment prologue and jumps straight to the
+// next handler through a per-page table of label addresses (see CodesThreaded.h).
+// The opcode bodies are the very same Codes*.h files used by the switch() version -
+// we simply turn each 'case X:' into the label 'X:' and each 'break' into the jump.
+//
+// All five pages are expanded inline so a prefixed opcode never leaves the function.
+// This makes for a much bigger chunk of code than the switch() version so it is not
+// placed into ITCM - benchmark both on real hardware before picking one.
+// -----------------------------------------------------------------------------------
+#include "CodesThreaded.h"
+
+#define Z80_NEXT                                                                    \
+  do {                                                                              \
+      if (CPU.TStates >= RunToCycles) return;                                      \
+      CONTEND(CPU.PC.W);                                                            \
+      I=OpZ80(CPU.PC.W++);                                                          \
+      CPU.TStates += Cycles_NoM1Wait[I];                                            \
+      PROF_OP(Z80_PROF_MAIN,I); PROF_PC();                                          \
+      INCR(1);                                                                      \
+      goto *MainTable[I];                                                           \
+  } while (0)
+
+void ExecZ80_Speccy(u32 RunToCycles)
+{
+  register byte I;
+  register pair J;
+
+  static const void * const MainTable[256] = THREADED_TABLE_MAIN;
+  static const void * const CBTable[256]   = THREADED_TABLE_CB;
+  static const void * const EDTable[256]   = THREADED_TABLE_ED;
+
+  (void)&&Main_BadOp; // All 256 main page opcodes are implemented so the Codes.h 'default' is never used here
+
+  Z80_NEXT;   // Fetch and dispatch the first opcode - every handler then chains to the next
+
+// From here on, the Codes*.h 'case' statements become labels and 'break' becomes the dispatch
+#define case
+#define break Z80_NEXT
+
+  // -------------------------------------
+  // Main opcode page
+  // -------------------------------------
+#define default Main_BadOp
+#include "Codes.h"
+#undef default
+
+  // -------------------------------------
+  // CB prefix page
+  // -------------------------------------
+PFX_CB:
+  I=OpZ80(CPU.PC.W++);
+  CPU.TStates += CyclesCB[I];
+  PROF_OP(Z80_PROF_CB,I);
+  INCR(1);
+  goto *CBTable[I];
+#include "CodesCB.h"
+
+  // -------------------------------------
+  // ED prefix page
+  // -------------------------------------
+PFX_ED:
+  I=OpZ80(CPU.PC.W++);
+  CPU.TStates += CyclesED[I];
+  PROF_OP(Z80_PROF_ED,I);
+  INCR(1);
+  goto *EDTable[I];
+#include "CodesED.h"
+ED_Repeat:
+  CPU.PC.W--;break;
+ED_BadOp:
+  if(CPU.TrapBadOps) Trap_Bad_Ops(" ED ", I, CPU.PC.W-4);
+  break;
+
+  // -------------------------------------
+  // DD prefix page (and DDCB)
+  // -------------------------------------
+  {
+    THREADED_LABELS_XX
+    static const void * const DDTable[256] = THREADED_TABLE_XX;
+#define XX IX
+PFX_DD:
+    I=OpZ80(CPU.PC.W++);
+    CPU.TStates += CyclesXX[I];
+    PROF_OP(Z80_PROF_DD,I);
+    INCR(1);
+    goto *DDTable[I];
+#include "CodesXX.h"
+XX_Repeat:
+    CPU.PC.W--;break;
+XX_BadOp:
+    if(CPU.TrapBadOps)  Trap_Bad_Ops(" DD ", I, CPU.PC.W-2);
+    break;
+XX_PfxCB:
+    {
+      THREADED_LABELS_XCB
+      static const void * const DDCBTable[256] = THREADED_TABLE_XCB;
+      J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
+      I=OpZ80(CPU.PC.W++);
+      CPU.TStates += CyclesXXCB[I];
+      PROF_OP(Z80_PROF_DDCB,I);
+      goto *DDCBTable[I];
+#include "CodesXCB.h"
+XCB_BadOp:
+      if(CPU.TrapBadOps)  Trap_Bad_Ops("DDCB", I, CPU.PC.W-4);
+      break;
+    }
+#undef XX
+  }
+
+  // -------------------------------------
+  // FD prefix page (and FDCB)
+  // -------------------------------------
+  {
+    THREADED_LABELS_XX
+    static const void * const FDTable[256] = THREADED_TABLE_XX;
+#define XX IY
+PFX_FD:
+    I=OpZ80(CPU.PC.W++);
+    CPU.TStates += CyclesXX[I];
+    PROF_OP(Z80_PROF_FD,I);
+    INCR(1);
+    goto *FDTable[I];
+#include "CodesXX.h"
+XX_Repeat:
+    CPU.PC.W--;break;
+XX_BadOp:
+    if(CPU.TrapBadOps)  Trap_Bad_Ops(" FD ", I, CPU.PC.W-2);
+    break;
+XX_PfxCB:
+    {
+      THREADED_LABELS_XCB
+      static const void * const FDCBTable[256] = THREADED_TABLE_XCB;
+      J.W=CPU.XX.W+(offset)OpZ80(CPU.PC.W++);
+      I=OpZ80(CPU.PC.W++);
+      CPU.TStates += CyclesXXCB[I];
+      PROF_OP(Z80_PROF_FDCB,I);
+      goto *FDCBTable[I];
+#include "CodesXCB.h"
+XCB_BadOp:
+      if(CPU.TrapBadOps)  Trap_Bad_Ops("FDCB", I, CPU.PC.W-4);
+      break;
+    }
+#undef XX
+  }
+
+#undef case
+#undef break
+}
+#endif // Z80_ASM / Z80_THREADED
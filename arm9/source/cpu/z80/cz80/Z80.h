@@ -27,11 +27,15 @@
 extern "C" {
 #endif
 
-//#define ZEXALL_TEST          /* Uncomment this to run the ZEXALL Z80 instruction test */
+//#define ZEXALL_TEST          /* Writable RAM at 0000-3FFF for the ZEXALL test (host/zex_test) */
 
                                /* Compilation options:       */
 #define LSB_FIRST              /* Compile for low-endian CPU */
 #define EXECZ80                /* Call Z80 each scanline     */
+//#define Z80_THREADED         /* Computed-goto dispatch     */
+                               /* (or make Z80_THREADED=1)   */
+//#define Z80_PROFILE          /* Opcode and PC hot-spots    */
+                               /* (or make Z80_PROFILE=1)    */
 
                                /* LoopZ80() may return:      */
 #define INT_RST00   0x00C7     /* RST 00h                    */
@@ -120,6 +124,49 @@ void ResetZ80(register Z80 *R);
 void ExecZ80_Speccy(u32 RunToCycles);
 #endif
 
+#ifdef Z80_ASM
+/** ExecOpcodeZ80() ******************************************/
+/** With Z80_ASM the main loop lives in armz80/ArmZ80.s and **/
+/** hands the rarer opcodes (prefixes, DAA, EI, I/O) back   **/
+/** to this C core. The opcode has already been fetched,    **/
+/** counted and had R incremented by the time we get here.  **/
+/*************************************************************/
+void ExecOpcodeZ80(byte I, u32 RunToCycles);
+#endif
+
+#ifdef Z80_PROFILE
+/** Profiler *************************************************/
+/** Execution counts per opcode for each of the seven pages **/
+/** (main, CB, ED, DD, FD, DDCB, FDCB) and a histogram of   **/
+/** the PC at each opcode fetch in 256-byte buckets. Only   **/
+/** built with Z80_PROFILE so it costs nothing otherwise.   **/
+/*************************************************************/
+#define Z80_PROF_MAIN    0
+#define Z80_PROF_CB      1
+#define Z80_PROF_ED      2
+#define Z80_PROF_DD      3
+#define Z80_PROF_FD      4
+#define Z80_PROF_DDCB    5
+#define Z80_PROF_FDCB    6
+#define Z80_PROF_PAGES   7
+
+extern u32 Z80_ProfOps[Z80_PROF_PAGES][256];
+extern u32 Z80_ProfPC[256];
+
+/** ResetProfileZ80() ****************************************/
+/** Clear all the profiler counters.                        **/
+/*************************************************************/
+void ResetProfileZ80(void);
+
+/** TopProfileZ80() ******************************************/
+/** Find the N busiest entries of a counter table and store **/
+/** their indexes (busiest first) into Idx[]. Returns the   **/
+/** number of non-zero entries found (at most N). Pass the  **/
+/** whole Z80_ProfOps[][] to rank opcodes across all pages. **/
+/*************************************************************/
+int TopProfileZ80(const u32 *Counts,int Size,int N,u16 *Idx);
+#endif
+
 /** IntZ80() *************************************************/
 /** This function will generate interrupt of given vector.  **/
 /*************************************************************/
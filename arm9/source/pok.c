@@ -96,6 +96,7 @@ void pok_apply(u8 sel)
             }
         }
     }
+    zx_screen_dirty_all(); // In case the poke landed on the screen
 }
 
 u8 num_pokes = 0;
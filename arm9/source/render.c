@@ -0,0 +1,302 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "SpeccySE.h"
+#include "SpeccyUtils.h"
+#include "render.h"
+
+// A fast look-up table when we are rendering background pixels
+u32 zx_colors_extend32[16] __attribute__((section(".dtcm"))) =
+{
+    0x00000000, 0x01010101, 0x02020202, 0x03030303,
+    0x04040404, 0x05050505, 0x06060606, 0x07070707,
+    0x08080808, 0x09090909, 0x0A0A0A0A, 0x0B0B0B0B,
+    0x0C0C0C0C, 0x0D0D0D0D, 0x0E0E0E0E, 0x0F0F0F0F
+};
+
+// ----------------------------------------------------------------------------
+// Four pixels (a nibble) to a byte mask over one 32-bit VRAM word. The left
+// most pixel is the high bit of the nibble but the lowest byte in VRAM.
+// ----------------------------------------------------------------------------
+u32 render_nibble_mask[16] __attribute__((section(".dtcm"))) =
+{
+    0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000,
+    0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
+    0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF,
+    0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF
+};
+
+// ----------------------------------------------------------------------------
+// Draw a run of 8-pixel character cells of one screen line into video memory.
+// This is the original kernel - check each pixel bit and shift ink or paper
+// into the right spot. Since the screen is often drawing background (paper
+// vs ink), that's handled via look-up table.
+// ----------------------------------------------------------------------------
+ITCM_CODE void render_cells_ternary(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count)
+{
+    for (u32 x=0; x<count; x++)
+    {
+        u8 attr = *attrPtr++;           // The color attribute and possible flashing
+        u8 paper = ((attr>>3) & 0x0F);  // Paper is the background
+        u8 pixel = *pixelPtr++;         // And here is 8 pixels to draw
+
+        if (attr & 0x80) // Flashing swaps pen/ink
+        {
+            if (bFlash) pixel = ~pixel; // Faster to just invert the pixel itself...
+        }
+
+        // --------------------------------------------------------------------------
+        // And now the pixel drawing... We try to speed this up as much as possible.
+        // --------------------------------------------------------------------------
+        if (pixel) // Is at least one pixel on?
+        {
+            u8 ink   = (attr & 0x07);       // Ink Color is the foreground
+            if (attr & 0x40) ink |= 0x08;   // Brightness
+
+            *vidBuf++ = (((pixel & 0x80) ? ink:paper)) | (((pixel & 0x40) ? ink:paper) << 8) | (((pixel & 0x20) ? ink:paper) << 16) | (((pixel & 0x10) ? ink:paper) << 24);
+            *vidBuf++ = (((pixel & 0x08) ? ink:paper)) | (((pixel & 0x04) ? ink:paper) << 8) | (((pixel & 0x02) ? ink:paper) << 16) | (((pixel & 0x01) ? ink:paper) << 24);
+        }
+        else // Just drawing all background which is common...
+        {
+            // ------------------------------------------------------------------
+            // Draw background directly to the screen via extended look-up table
+            // ------------------------------------------------------------------
+            *vidBuf++ = zx_colors_extend32[paper];
+            *vidBuf++ = zx_colors_extend32[paper];
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// The same again but blending whole words - each nibble of the pixel byte
+// picks a byte mask and (mask & ink) | (~mask & paper) is done as one XOR
+// with the ink and paper already spread across all four bytes.
+// ----------------------------------------------------------------------------
+ITCM_CODE void render_cells_mask(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count)
+{
+    u8 flash = bFlash ? 0x80:0x00;      // Only flashing cells invert in this half of the cycle
+
+    for (u32 x=0; x<count; x++)
+    {
+        u8 attr = *attrPtr++;
+        u8 pixel = *pixelPtr++;
+        u32 paper32 = zx_colors_extend32[(attr>>3) & 0x0F];
+
+        if (attr & flash) pixel = ~pixel;
+
+        if (pixel)
+        {
+            u32 blend = zx_colors_extend32[(attr & 0x07) | ((attr & 0x40) >> 3)] ^ paper32;
+            *vidBuf++ = paper32 ^ (render_nibble_mask[pixel >> 4]   & blend);
+            *vidBuf++ = paper32 ^ (render_nibble_mask[pixel & 0x0F] & blend);
+        }
+        else
+        {
+            *vidBuf++ = paper32;
+            *vidBuf++ = paper32;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// The kernels to choose from - the ARM assembly one only exists on the DS.
+// Until render_benchmark() has run we draw with the original kernel.
+// ----------------------------------------------------------------------------
+render_cells_t render_kernels[RENDER_KERNELS] =
+{
+    render_cells_ternary,
+    render_cells_mask,
+#ifdef __arm__
+    render_cells_arm,
+#else
+    NULL,
+#endif
+};
+
+const char *render_kernel_names[RENDER_KERNELS] = {"TERNARY", "MASK", "ARM ASM"};
+
+render_cells_t render_cells __attribute__((section(".dtcm"))) = render_cells_ternary;
+u8  render_kernel = RENDER_TERNARY;
+u32 render_bench_ns[RENDER_KERNELS];    // Best time to draw one 256 pixel line (0 if not run)
+u8  render_bench_ok[RENDER_KERNELS];    // And did it draw exactly what the original kernel did
+
+void render_select(u8 kernel)
+{
+    if ((kernel >= RENDER_KERNELS) || (render_kernels[kernel] == NULL)) return;
+    render_kernel = kernel;
+    render_cells = render_kernels[kernel];
+}
+
+// ----------------------------------------------------------------------------
+// Lines can be drawn into a small RAM buffer and handed to a DMA channel to
+// copy into VRAM while we get on with the emulation, rather than the kernel
+// writing VRAM (the slower bus) itself. The DMA can't see the TCMs so the two
+// line buffers are in main RAM - the kernel writes them through the cache and
+// we flush the line before the DMA reads it. Only one line is ever in flight
+// so by the time a buffer comes around again its DMA is long finished.
+// Whether this beats writing VRAM directly is up to render_benchmark().
+// ----------------------------------------------------------------------------
+#define RENDER_DMA          1   // Channel 0 is the border HBlank DMA and 3 is dmaCopy()
+
+u8  render_dma = 0;
+u32 render_bench_dma_ns = 0;    // Best time for a line drawn by the chosen kernel through the DMA
+
+static u32 render_line_buf[2][64] ALIGN(32);
+static u8  render_line_idx = 0;
+
+ITCM_CODE void render_line_wait(void)
+{
+#ifndef HOST_BUILD
+    while (DMA_CR(RENDER_DMA) & DMA_BUSY) asm("nop");
+#endif
+}
+
+ITCM_CODE u32 *render_line_begin(u32 *vidBuf)
+{
+    if (!render_dma) return vidBuf;
+    render_line_idx ^= 1;
+    return render_line_buf[render_line_idx];
+}
+
+ITCM_CODE void render_line_end(u32 *vidBuf, u32 *lineBuf)
+{
+    if (lineBuf == vidBuf) return;
+#ifdef HOST_BUILD
+    memcpy(vidBuf, lineBuf, 256);
+#else
+    DC_FlushRange(lineBuf, 256);
+    render_line_wait();
+    DMA_SRC(RENDER_DMA)  = (u32)lineBuf;
+    DMA_DEST(RENDER_DMA) = (u32)vidBuf;
+    DMA_CR(RENDER_DMA)   = DMA_ENABLE | DMA_32_BIT | DMA_SRC_INC | DMA_DST_INC | 64;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// On the DS we time with TIMER3 (free on the ARM9 - maxmod has TIMER0 and the
+// main loop TIMER1 and TIMER2) at the bus clock / 64 which is ~1.9us a tick
+// and wraps after 125ms. The host has a proper nanosecond clock.
+// ----------------------------------------------------------------------------
+#ifdef HOST_BUILD
+typedef u64 render_clock_t;
+static inline render_clock_t render_clock_start(void) {return host_now_ns();}
+static inline u32 render_clock_ns(render_clock_t start) {return (u32)(host_now_ns() - start);}
+#else
+typedef u16 render_clock_t;
+static inline render_clock_t render_clock_start(void)
+{
+    TIMER3_CR = 0;
+    TIMER3_DATA = 0;
+    TIMER3_CR = TIMER_ENABLE | TIMER_DIV_64;
+    return 0;
+}
+static inline u32 render_clock_ns(render_clock_t start)
+{
+    u16 ticks = TIMER3_DATA - start;
+    TIMER3_CR = 0;
+    return (u32)(((u64)ticks * 64 * 1000000000ULL) / BUS_CLOCK);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Time every kernel drawing the same made-up screen into vidBuf (a whole
+// 256x192 buffer which is scribbled on - so one not being shown) and pick
+// the fastest one that draws exactly what the original kernel does. The
+// screen is roughly a third blank cells with some flashing and bright ones
+// so the fast path for background is timed along with the pixel blending.
+// ----------------------------------------------------------------------------
+void render_benchmark(u32 *vidBuf)
+{
+    static u8  screen[0x1B00] ALIGN(4);
+    static u32 reference[8][64];
+    u32 seed = 0x5EECC1E5;
+
+    for (u32 i=0; i<sizeof(screen); i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        u8 value = seed >> 16;
+        screen[i] = ((i < 0x1800) && ((seed >> 28) < 5)) ? 0x00 : value;
+    }
+
+    u8 savedFlash = bFlash;
+    u8 best = RENDER_TERNARY;
+
+    for (u8 k=0; k<RENDER_KERNELS; k++)
+    {
+        render_bench_ns[k] = 0;
+        render_bench_ok[k] = 0;
+        if (render_kernels[k] == NULL) continue;
+
+        // Check the output first - both halves of the flash cycle over a character row
+        u8 ok = 1;
+        for (u8 flash=0; flash<2; flash++)
+        {
+            bFlash = flash;
+            for (u8 line=0; line<4; line++)
+            {
+                u8 *pixelPtr = &screen[(flash*4 + line) << 8];
+                u8 *attrPtr  = &screen[0x1800 + (flash*4 + line) * 32];
+                if (k == RENDER_TERNARY) render_kernels[k](reference[flash*4 + line], pixelPtr, attrPtr, 32);
+                else
+                {
+                    render_kernels[k](vidBuf, pixelPtr, attrPtr, 32);
+                    if (memcmp(vidBuf, reference[flash*4 + line], 256)) ok = 0;
+                }
+            }
+        }
+        render_bench_ok[k] = ok;
+
+        u32 best_ns = 0xFFFFFFFF;
+        for (u8 pass=0; pass<RENDER_BENCH_PASSES; pass++)
+        {
+            bFlash = pass & 1;
+            render_clock_t start = render_clock_start();
+            for (u32 line=0; line<192; line++)
+            {
+                render_kernels[k](vidBuf + (line << 6), &screen[line << 5], &screen[0x1800 + ((line/8)*32)], 32);
+            }
+            u32 ns = render_clock_ns(start);
+            if (ns < best_ns) best_ns = ns;
+        }
+        render_bench_ns[k] = best_ns / 192;
+
+        if (ok && (render_bench_ns[k] < render_bench_ns[best])) best = k;
+    }
+
+    // And now the winner again but through the line buffers and the DMA
+    render_select(best);
+    render_dma = 1;
+    u32 best_ns = 0xFFFFFFFF;
+    for (u8 pass=0; pass<RENDER_BENCH_PASSES; pass++)
+    {
+        bFlash = pass & 1;
+        render_clock_t start = render_clock_start();
+        for (u32 line=0; line<192; line++)
+        {
+            u32 *lineBuf = render_line_begin(vidBuf + (line << 6));
+            render_cells(lineBuf, &screen[line << 5], &screen[0x1800 + ((line/8)*32)], 32);
+            render_line_end(vidBuf + (line << 6), lineBuf);
+        }
+        render_line_wait();
+        u32 ns = render_clock_ns(start);
+        if (ns < best_ns) best_ns = ns;
+    }
+    render_bench_dma_ns = best_ns / 192;
+    render_dma = (render_bench_dma_ns < render_bench_ns[best]);
+
+    bFlash = savedFlash;
+}
+
+// End of file
@@ -0,0 +1,56 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#ifndef _RENDER_H_
+#define _RENDER_H_
+
+#include <nds.h>
+
+// ---------------------------------------------------------------------------
+// The character cell renderer kernels. Each one draws a run of 8-pixel cells
+// of one screen line (a pixel byte plus its color attribute) as 8 bytes of
+// 8-bit bitmap VRAM. They all produce exactly the same pixels - which one is
+// fastest is down to the hardware so render_benchmark() times them all and
+// render_cells points at the winner.
+// ---------------------------------------------------------------------------
+#define RENDER_TERNARY      0   // Test each pixel bit and pick ink or paper
+#define RENDER_MASK         1   // Nibble to byte-mask table blending ink and paper
+#define RENDER_ARM          2   // Hand-written ARM assembly version of the mask blend
+#define RENDER_KERNELS      3
+
+#define RENDER_BENCH_PASSES 8   // Whole screens drawn by each kernel - the best one counts
+
+typedef void (*render_cells_t)(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count);
+
+extern void render_cells_ternary(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count);
+extern void render_cells_mask(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count);
+extern void render_cells_arm(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count);
+
+extern render_cells_t render_cells;
+extern render_cells_t render_kernels[RENDER_KERNELS];
+extern const char *render_kernel_names[RENDER_KERNELS];
+extern u8  render_kernel;
+extern u32 render_bench_ns[RENDER_KERNELS];
+extern u8  render_bench_ok[RENDER_KERNELS];
+
+extern u32 zx_colors_extend32[16];
+extern u32 render_nibble_mask[16];
+
+extern u8  render_dma;
+extern u32 render_bench_dma_ns;
+
+extern u32 *render_line_begin(u32 *vidBuf);
+extern void render_line_end(u32 *vidBuf, u32 *lineBuf);
+extern void render_line_wait(void);
+
+extern void render_benchmark(u32 *vidBuf);
+extern void render_select(u8 kernel);
+
+#endif // _RENDER_H_
@@ -0,0 +1,87 @@
+;@
+;@  render_arm.s
+;@  ARM assembly character cell renderer for SpeccySE.
+;@
+;@  The same mask blend as render_cells_mask() in render.c - each nibble of
+;@  the pixel byte picks a byte mask which blends ink into paper for four
+;@  pixels at a time. Flash and bright are handled with conditional execution
+;@  rather than branches and each cell goes out as one 8 byte stmia.
+;@  render_benchmark() decides if this is the kernel we draw with.
+;@
+#ifdef __arm__
+
+	.global render_cells_arm
+
+	.extern bFlash
+	.extern zx_colors_extend32
+	.extern render_nibble_mask
+
+	.syntax unified
+	.arm
+
+#ifdef NDS
+	.section .itcm,"ax"			;@ For the NDS
+#else
+	.section .text
+#endif
+	.align 2
+;@----------------------------------------------------------------------------
+;@ void render_cells_arm(u32 *vidBuf, u8 *pixelPtr, u8 *attrPtr, u32 count)
+;@ r0  = vidBuf - 8 bytes written for every cell.
+;@ r1  = pixelPtr
+;@ r2  = attrPtr
+;@ r3  = cells left to draw.
+;@ r4  = 0x80 when flashing cells are inverted this frame, else 0.
+;@ r5  = zx_colors_extend32 - a color spread over all four bytes.
+;@ r6  = render_nibble_mask
+;@ r7  = attribute, r8 = pixels, r9 = paper, r10 = ink ^ paper.
+;@ r12 = left 4 pixels, lr = right 4 pixels.
+;@----------------------------------------------------------------------------
+render_cells_arm:
+	.type render_cells_arm STT_FUNC
+;@----------------------------------------------------------------------------
+	cmp r3,#0
+	bxeq lr
+	stmfd sp!,{r4-r10,lr}
+	ldr r4,=bFlash
+	ldrb r4,[r4]
+	cmp r4,#0
+	movne r4,#0x80
+	ldr r5,=zx_colors_extend32
+	ldr r6,=render_nibble_mask
+cellLoop:
+	ldrb r7,[r2],#1				;@ Color attribute
+	ldrb r8,[r1],#1				;@ And the 8 pixels it colors
+	mov r9,r7,lsr#3
+	and r9,r9,#0x0F
+	ldr r9,[r5,r9,lsl#2]		;@ Paper
+	tst r7,r4
+	eorne r8,r8,#0xFF			;@ Flashing cell in its inverted half
+	cmp r8,#0
+	moveq r10,r9
+	stmiaeq r0!,{r9,r10}		;@ Nothing but paper which is common...
+	beq cellNext
+
+	and r10,r7,#0x07
+	tst r7,#0x40
+	orrne r10,r10,#0x08			;@ Bright
+	ldr r10,[r5,r10,lsl#2]		;@ Ink
+	mov r12,r8,lsr#4
+	and lr,r8,#0x0F
+	ldr r12,[r6,r12,lsl#2]		;@ Mask for the left 4 pixels
+	ldr lr,[r6,lr,lsl#2]		;@ Mask for the right 4 pixels
+	eor r10,r10,r9
+	and r12,r12,r10
+	and lr,lr,r10
+	eor r12,r12,r9				;@ Paper with the ink blended in
+	eor lr,lr,r9
+	stmia r0!,{r12,lr}
+cellNext:
+	subs r3,r3,#1
+	bne cellLoop
+	ldmfd sp!,{r4-r10,pc}
+;@----------------------------------------------------------------------------
+	.ltorg
+;@----------------------------------------------------------------------------
+	.end
+#endif // #ifdef __arm__
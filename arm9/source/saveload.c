@@ -25,7 +25,7 @@
 
 #include "lzav.h"
 
-#define SPECCY_SAVE_VER   0x0005       // Change this if the basic format of the .SAV file changes. Invalidates older .sav files.
+#define SPECCY_SAVE_VER   0x0006       // Change this if the basic format of the .SAV file changes. Invalidates older .sav files.
 
 // -----------------------------------------------------------------------------------------------------
 // Since the main MemoryMap[] can point to differt things (RAM, ROM, BIOS, etc) and since we can't rely
@@ -142,18 +142,19 @@ void spectrumSaveState()
     if (retVal) retVal = fwrite(&tape_state,                sizeof(tape_state),                 1, handle);
     if (retVal) retVal = fwrite(&current_block_data_idx,    sizeof(current_block_data_idx),     1, handle);
     if (retVal) retVal = fwrite(&tape_bytes_processed,      sizeof(tape_bytes_processed),       1, handle);
-    if (retVal) retVal = fwrite(&header_pulses,             sizeof(header_pulses),              1, handle);
+    if (retVal) retVal = fwrite(&tape_run_left,             sizeof(tape_run_left),              1, handle);
     if (retVal) retVal = fwrite(&current_bit,               sizeof(current_bit),                1, handle);
     if (retVal) retVal = fwrite(&current_bytes_this_block,  sizeof(current_bytes_this_block),   1, handle);
     if (retVal) retVal = fwrite(&handle_last_bits,          sizeof(handle_last_bits),           1, handle);
-    if (retVal) retVal = fwrite(&custom_pulse_idx,          sizeof(custom_pulse_idx),           1, handle);
+    if (retVal) retVal = fwrite(&current_run,               sizeof(current_run),                1, handle);
     if (retVal) retVal = fwrite(&bFirstTime,                sizeof(bFirstTime),                 1, handle);
     if (retVal) retVal = fwrite(&loop_counter,              sizeof(loop_counter),               1, handle);
     if (retVal) retVal = fwrite(&loop_block,                sizeof(loop_block),                 1, handle);
     if (retVal) retVal = fwrite(&last_edge,                 sizeof(last_edge),                  1, handle);
     if (retVal) retVal = fwrite(&give_up_counter,           sizeof(give_up_counter),            1, handle);
-    if (retVal) retVal = fwrite(&next_edge1,                sizeof(next_edge1),                 1, handle);
-    if (retVal) retVal = fwrite(&next_edge2,                sizeof(next_edge2),                 1, handle);
+    if (retVal) retVal = fwrite(&tape_edge_end,             sizeof(tape_edge_end),              1, handle);
+    if (retVal) retVal = fwrite(&tape_bit_end,              sizeof(tape_bit_end),               1, handle);
+    if (retVal) retVal = fwrite(&tape_level,                sizeof(tape_level),                 1, handle);
     if (retVal) retVal = fwrite(&spare,                     sizeof(spare),                      1, handle);
     if (retVal) retVal = fwrite(&spare,                     sizeof(spare),                      1, handle);
     if (retVal) retVal = fwrite(&spare,                     sizeof(spare),                      1, handle);
@@ -281,29 +282,37 @@ void spectrumLoadState()
         if (retVal) retVal = fread(&zx_128k_mode,              sizeof(zx_128k_mode),               1, handle);
         if (retVal) retVal = fread(&zx_ScreenRendering,        sizeof(zx_ScreenRendering),         1, handle);
         if (retVal) retVal = fread(&zx_current_line,           sizeof(zx_current_line),            1, handle);
+        
+        zx_contend_rebuild();   // Paging and rendering state are restored - bring memory contention in line
+        zx_contend_set_base();  // Along with where it starts on the next line
+        zx_screen_rebuild();    // Same for where the screen page is mapped
+        zx_screen_dirty_all();  // And the screen memory itself has been replaced
 
         if (retVal) retVal = fread(&num_blocks_available,      sizeof(num_blocks_available),       1, handle);
         if (retVal) retVal = fread(&current_block,             sizeof(current_block),              1, handle);
         if (retVal) retVal = fread(&tape_state,                sizeof(tape_state),                 1, handle);
         if (retVal) retVal = fread(&current_block_data_idx,    sizeof(current_block_data_idx),     1, handle);
         if (retVal) retVal = fread(&tape_bytes_processed,      sizeof(tape_bytes_processed),       1, handle);
-        if (retVal) retVal = fread(&header_pulses,             sizeof(header_pulses),              1, handle);
+        if (retVal) retVal = fread(&tape_run_left,             sizeof(tape_run_left),              1, handle);
         if (retVal) retVal = fread(&current_bit,               sizeof(current_bit),                1, handle);
         if (retVal) retVal = fread(&current_bytes_this_block,  sizeof(current_bytes_this_block),   1, handle);
         if (retVal) retVal = fread(&handle_last_bits,          sizeof(handle_last_bits),           1, handle);
-        if (retVal) retVal = fread(&custom_pulse_idx,          sizeof(custom_pulse_idx),           1, handle);
+        if (retVal) retVal = fread(&current_run,               sizeof(current_run),                1, handle);
         if (retVal) retVal = fread(&bFirstTime,                sizeof(bFirstTime),                 1, handle);
         if (retVal) retVal = fread(&loop_counter,              sizeof(loop_counter),               1, handle);
         if (retVal) retVal = fread(&loop_block,                sizeof(loop_block),                 1, handle);
         if (retVal) retVal = fread(&last_edge,                 sizeof(last_edge),                  1, handle);
         if (retVal) retVal = fread(&give_up_counter,           sizeof(give_up_counter),            1, handle);
-        if (retVal) retVal = fread(&next_edge1,                sizeof(next_edge1),                 1, handle);
-        if (retVal) retVal = fread(&next_edge2,                sizeof(next_edge2),                 1, handle);
+        if (retVal) retVal = fread(&tape_edge_end,             sizeof(tape_edge_end),              1, handle);
+        if (retVal) retVal = fread(&tape_bit_end,              sizeof(tape_bit_end),               1, handle);
+        if (retVal) retVal = fread(&tape_level,                sizeof(tape_level),                 1, handle);
         if (retVal) retVal = fread(&spare,                     sizeof(spare),                      1, handle);
         if (retVal) retVal = fread(&spare,                     sizeof(spare),                      1, handle);
         if (retVal) retVal = fread(&spare,                     sizeof(spare),                      1, handle);
         if (retVal) retVal = fread(&spare,                     sizeof(spare),                      1, handle);
 
+        tape_rebuild();         // The runs of the block the tape is part way through are compiled again
+
         // Load Z80 Memory Map... either 48K for 128K
         int comp_len = 0;
         if (retVal) retVal = fread(&comp_len,          sizeof(comp_len), 1, handle);
@@ -0,0 +1,561 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#include <nds.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <maxmod9.h>
+
+#include "SpeccySE.h"
+#include "SpeccyUtils.h"
+#include "cpu/z80/Z80_interface.h"
+#include "sound7.h"
+
+// ---------------------------------------------------------------------------------
+// The sample ring buffer, the beeper/AY direct mixer and the maxmod stream callback
+// live here so the emulation core (spectrum.c) can be built without the rest of
+// the NDS front-end - for example by the headless host benchmark in host/
+// ---------------------------------------------------------------------------------
+u8 soundEmuPause     __attribute__((section(".dtcm"))) = 1;       // Set to 1 to pause (mute) sound, 0 is sound unmuted (sound channels active)
+SoundShare_t *snd7  __attribute__((section(".dtcm"))) = NULL;    // Set while the ARM7 is doing the mixing (see sound_arm7_start)
+u8 audio_low        __attribute__((section(".dtcm"))) = 0;       // LOW sound quality - half the samples (see sound_set_quality)
+
+// T-states per sample - a quarter of a scanline or, at the LOW sound quality, half of one
+static inline s32 audio_period(void)
+{
+    return (zx_128k_mode ? 228:224) >> (audio_low ? 1:2);
+}
+
+// And its reciprocal in 8.24 fixed point for placing the beeper edges
+static inline u32 audio_recip(void)
+{
+    return (zx_128k_mode ? ((1<<24)/(228/4)):((1<<24)/(224/4))) >> audio_low;
+}
+
+// ------------------------------------------------------------
+// Utility function to pause the sound...
+// ------------------------------------------------------------
+void SoundPause(void)
+{
+    soundEmuPause = 1;
+    if (snd7) snd7->pause = 1;
+}
+
+// ------------------------------------------------------------
+// Utility function to un pause the sound...
+// ------------------------------------------------------------
+void SoundUnPause(void)
+{
+    soundEmuPause = 0;
+    if (snd7) snd7->pause = 0;
+}
+
+u16 mixer_read      __attribute__((section(".dtcm"))) = 0;
+u16 mixer_write     __attribute__((section(".dtcm"))) = 0;
+s16 mixer[WAVE_DIRECT_BUF_SIZE+1];
+
+// -------------------------------------------------------------------------------------------
+// The emulation makes samples at its own pace - never quite the rate the stream plays them at
+// and faster or slower with the game speed. Rather than dropping samples when the ring fills
+// and repeating the last one when it runs dry, the stream reads the ring at a fractional rate
+// (interpolating between samples) and that rate is nudged to hold the ring at MIXER_TARGET.
+// That is low enough that a whole frame of samples (1248) made in one go still fits on top.
+// The fill is averaged over ~16 callbacks as it swings by a frame's worth as each frame is
+// run. The proportional term takes out the swing and the integral term finds the rate the
+// two sides balance at - the limit of 1/32 either side of the game speed is plenty for that.
+// -------------------------------------------------------------------------------------------
+#define MIXER_TARGET    ((WAVE_DIRECT_BUF_SIZE+1) * 3 / 8)
+#define MIXER_INTEGRAL  (1 << 17)   // Enough for the integral term to reach the limit on its own
+
+u32 mixer_nominal   __attribute__((section(".dtcm"))) = (1 << 16);    // Ring samples per stream sample (16.16) for the game speed
+u32 mixer_ratio     __attribute__((section(".dtcm"))) = (1 << 16);    // And what we're actually reading at
+u32 mixer_frac      __attribute__((section(".dtcm"))) = 0;
+s32 mixer_integral  __attribute__((section(".dtcm"))) = 0;
+u32 mixer_fill_avg  __attribute__((section(".dtcm"))) = (MIXER_TARGET << 8);  // 24.8 fixed point
+u32 mixer_underruns = 0;    // Stream callbacks that ran the ring dry
+u32 mixer_overruns  = 0;    // Batches that didn't all fit in the ring
+
+// The game speed (80% to 120%) sets how fast we read the ring before the controller trims it
+void mixer_set_speed(u32 percent)
+{
+    mixer_nominal = (percent << 16) / 100;
+    mixer_ratio = mixer_nominal;
+}
+
+static inline void mixer_control(u16 fill)
+{
+    mixer_fill_avg += ((s32)(fill << 8) - (s32)mixer_fill_avg) >> 4;
+    s32 err = (s32)(mixer_fill_avg >> 8) - (MIXER_TARGET >> audio_low);     // Same latency at LOW
+
+    mixer_integral += err;
+    if (mixer_integral >  MIXER_INTEGRAL) mixer_integral =  MIXER_INTEGRAL;
+    if (mixer_integral < -MIXER_INTEGRAL) mixer_integral = -MIXER_INTEGRAL;
+
+    s32 adjust = ((err * (s32)mixer_nominal) >> 14) + (((mixer_integral >> 6) * (s32)(mixer_nominal >> 8)) >> 8);
+    s32 limit = mixer_nominal >> 5;
+    if (adjust >  limit) adjust =  limit;
+    if (adjust < -limit) adjust = -limit;
+    mixer_ratio = mixer_nominal + adjust;
+}
+
+// -------------------------------------------------------------------------------------------
+// maxmod will call this routine when the buffer is half-empty and requests that
+// we fill the sound buffer with more samples. They will request 'len' samples and
+// we will fill exactly that many. If the sound is paused, we fill with 'mute' samples.
+// -------------------------------------------------------------------------------------------
+s16 last_sample __attribute__((section(".dtcm"))) = 0;
+
+ITCM_CODE mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats format)
+{
+    if (soundEmuPause)  // If paused, just "mix" in mute sound chip... all channels are OFF
+    {
+        s16 *p = (s16*)dest;
+        for (int i=0; i<len; i++)
+        {
+           *p++ = last_sample;      // To prevent pops and clicks... just keep outputting the last sample
+           *p++ = last_sample;      // To prevent pops and clicks... just keep outputting the last sample
+        }
+    }
+    else
+    {
+        s16 *p = (s16*)dest;
+        u16 fill = (mixer_write - mixer_read) & WAVE_DIRECT_BUF_SIZE;
+        u8 dry = 0;
+        for (int i=0; i<len*2; i++)
+        {
+            if (fill < 2) {*p++ = last_sample; dry = 1; continue;}     // Nothing to go between
+
+            s32 a = mixer[mixer_read];
+            s32 b = mixer[(mixer_read + 1) & WAVE_DIRECT_BUF_SIZE];
+            last_sample = a + (((b - a) * (s32)(mixer_frac >> 1)) >> 15);
+            *p++ = last_sample;
+
+            mixer_frac += mixer_ratio;
+            u16 step = mixer_frac >> 16;
+            mixer_frac &= 0xFFFF;
+            if (step > fill-1) step = fill-1;
+            mixer_read = (mixer_read + step) & WAVE_DIRECT_BUF_SIZE;
+            fill -= step;
+        }
+        if (dry) mixer_underruns++;
+        mixer_control((mixer_write - mixer_read) & WAVE_DIRECT_BUF_SIZE);
+    }
+
+    return  len;
+}
+
+// --------------------------------------------------------------------------------------------
+// When the ARM7 is doing the mixing (the SOUND CPU option) no samples are made here. Each
+// beeper edge and AY write goes into the ring shared with the ARM7 (see sound7.h) as the Z80
+// makes it - with where it falls worked out just as it would be here - and the samples are
+// counted and sent on ahead of the next command. Our own AY still takes the writes so the
+// Z80 can read the registers back and save states have them. If the ring is ever full (the
+// emulation is running ahead of the audio) commands are dropped and, once there is room, the
+// ARM7 is put back in step with the AY registers and the speaker as they are now.
+// --------------------------------------------------------------------------------------------
+SoundShare_t snd7_share ALIGN(32);
+u8  snd7_samples                __attribute__((section(".dtcm"))) = 0;  // Samples made but not yet sent
+u8  snd7_lost                   __attribute__((section(".dtcm"))) = 0;  // A command was dropped
+u8  snd7_index                  __attribute__((section(".dtcm"))) = 0;  // What the ARM7 AY was last told...
+u8  snd7_ay_enabled             __attribute__((section(".dtcm"))) = 0;
+u8  snd7_regs[16]               __attribute__((section(".dtcm")));
+
+static inline void snd7_post(u32 cmd)
+{
+    u16 head = snd7->head;
+    u16 next = (head + 1) & (SND7_RING-1);
+    if (next == snd7->tail) {snd7_lost = 1; return;}
+    snd7->ring[head] = cmd;
+    snd7->head = next;
+}
+
+// Send the samples made so far so that the next command lands after them
+static inline void snd7_post_samples(void)
+{
+    if (snd7_samples) snd7_post(SND7_SAMPLES | snd7_samples);
+    snd7_samples = 0;
+}
+
+// -----------------------------------------------------------------------------------------
+// Tell the ARM7 AY about any register it doesn't have. Normally there are none but after a
+// reset, a snapshot or a save state load our AY has been set up directly.
+// -----------------------------------------------------------------------------------------
+static void snd7_ay_sync(u8 all)
+{
+    for (u8 reg=0; reg<14; reg++)
+    {
+        if (all || (snd7_regs[reg] != myAY.ayRegs[reg]))
+        {
+            snd7_post(SND7_AY | reg);
+            snd7_post(SND7_AY | 0x200 | myAY.ayRegs[reg]);
+            snd7_regs[reg] = myAY.ayRegs[reg];
+            snd7_index = reg;
+        }
+    }
+    if (all || (snd7_index != myAY.ayRegIndex))
+    {
+        snd7_post(SND7_AY | myAY.ayRegIndex);
+        snd7_index = myAY.ayRegIndex;
+    }
+    if (all || (snd7_ay_enabled != zx_AY_enabled))
+    {
+        snd7_post(SND7_AY_ENABLE | (zx_AY_enabled ? 1:0));
+        snd7_ay_enabled = zx_AY_enabled;
+    }
+}
+
+// Something was dropped - once the ARM7 has caught up start it again from where we are now
+static void snd7_resync(void)
+{
+    if (((snd7->tail - snd7->head - 1) & (SND7_RING-1)) < (SND7_RING/2)) return;
+    snd7_lost = 0;
+    snd7_samples = 0;
+    snd7_post(SND7_SYNC | ((portFE & 0x10) ? 1:0));
+    snd7_ay_sync(1);
+}
+
+// --------------------------------------------------------------------------------------------
+// The beeper. Rather than looking at the speaker bit of port FE when we take a sample (and
+// aliasing everything the Z80 does in between), every OUT which flips the speaker is logged
+// with its T-state and turned into a band-limited step when the samples are made. The step
+// is spread over 8 samples by a table (a windowed sinc, at 32 sub-sample phases) of deltas
+// which are summed into a short ring and integrated as each sample goes out. The samples
+// run BEEPER_LAG samples behind the Z80 so that every edge which touches a sample is in the
+// ring before that sample is taken. The work is per edge - a quiet beeper costs nothing.
+// The step table and its sizes are in sound7.h as the ARM7 makes the same steps.
+// --------------------------------------------------------------------------------------------
+#define BEEPER_LAG      7       // How many samples we run behind the Z80
+#define BEEPER_LOG      64      // OUTs are at least 11 T-states apart so a half line holds ~12
+
+typedef struct
+{
+    u32 tstates;
+    s32 delta;
+} BeeperEdge_t;
+
+BeeperEdge_t beeper_log[BEEPER_LOG];
+u8  beeper_log_len              __attribute__((section(".dtcm"))) = 0;
+u8  beeper_pos                  __attribute__((section(".dtcm"))) = 0;
+s32 beeper_clock                __attribute__((section(".dtcm"))) = 0;  // T-state of the next sample out
+s32 beeper_level                __attribute__((section(".dtcm"))) = 0;  // Running sum of the deltas (<< BEEPER_SHIFT)
+s32 beeper_ring[BEEPER_RING]    __attribute__((section(".dtcm")));
+
+// Where an edge 'offset' T-states past the next sample out goes - in samples, 8.24 fixed point
+static inline u32 beeper_where(s32 offset, s32 period, u32 recip)
+{
+    if (offset < 3*period) offset = 3*period;   // Only if we fell behind
+    if (offset > (BEEPER_RING-BEEPER_TAPS+2)*period) offset = (BEEPER_RING-BEEPER_TAPS+2)*period;
+    return (u32)offset * recip;
+}
+
+// Called by the OUT handler whenever the speaker bit of port FE changes
+ITCM_CODE void beeper_edge(u32 tstates, u8 speaker)
+{
+    if (snd7)   // The ARM7 makes the step - send it where the edge goes right away
+    {
+        if (beeper_log_len < BEEPER_LOG)
+        {
+            beeper_log_len++;
+            u32 pos = beeper_where((s32)tstates - beeper_clock, audio_period(), audio_recip());
+            snd7_post_samples();
+            snd7_post(SND7_BEEPER | (speaker ? 0x400:0) | ((pos >> 19) & 0x3FF));
+        }
+        return;
+    }
+
+    if (beeper_log_len < BEEPER_LOG)
+    {
+        beeper_log[beeper_log_len].tstates = tstates;
+        beeper_log[beeper_log_len].delta = speaker ? BEEPER_VOLUME : -BEEPER_VOLUME;
+        beeper_log_len++;
+    }
+}
+
+// ----------------------------------------------------------------------------------------
+// Start the samples again BEEPER_LAG behind the Z80 at whatever level the speaker is at.
+// This happens when we lose track (after the tape or a snapshot load) and at reset.
+// ----------------------------------------------------------------------------------------
+static void beeper_sync(s32 period)
+{
+    memset(beeper_ring, 0x00, sizeof(beeper_ring));
+    beeper_log_len = 0;
+    beeper_level = (portFE & 0x10) ? (BEEPER_VOLUME << BEEPER_SHIFT) : 0;
+    beeper_clock = (s32)CPU.TStates - (BEEPER_LAG * period);
+    if (snd7)
+    {
+        snd7_post_samples();
+        snd7_post(SND7_SYNC | ((portFE & 0x10) ? 1:0));
+    }
+}
+
+// Spread one edge over the ring - 'offset' is how far (in T-states) it is past the next sample out
+static inline void beeper_step(s32 offset, s32 delta, s32 period, u32 recip)
+{
+    u32 pos = beeper_where(offset, period, recip);
+    const s16 *blep = beeper_blep[(pos >> 19) & (BEEPER_PHASES-1)];
+    u8 idx = beeper_pos + (pos >> 24) - 3;
+    for (u8 j=0; j<BEEPER_TAPS; j++)
+    {
+        beeper_ring[(idx + j) & (BEEPER_RING-1)] += delta * blep[j];
+    }
+}
+
+// --------------------------------------------------------------------------------------------
+// The AY. Rather than asking the AY mixer for 2 samples at a time (1248 calls a frame), the
+// samples are made in batches of AUDIO_BATCH. Writes to the AY registers are logged with the
+// sample of the batch they land on and, once the batch of beeper samples is in, we replay the
+// log - running the AY mixer up to each write, making the write, and on to the next one. So
+// a game playing samples through the AY volume registers is still heard at the right times.
+// The batch is also finished at the end of each frame so nothing is left over between them.
+// --------------------------------------------------------------------------------------------
+#define AUDIO_BATCH     64      // Samples (16 scanlines) made before the AY runs and the batch is mixed
+#define AY_LOG          256     // Plenty for a batch - if it ever fills we just catch up there and then
+
+typedef struct
+{
+    u8 sample;                  // Which sample of the batch the write takes effect on
+    u8 data;                    // 0 for a write to the register index, 1 for the register itself
+    u8 value;
+    u8 unused;
+} AYWrite_t;
+
+AYWrite_t ay_log[AY_LOG];
+u16 ay_log_len                  __attribute__((section(".dtcm"))) = 0;
+u8  ay_pos                      __attribute__((section(".dtcm"))) = 0;  // AY samples made so far this batch
+u8  audio_len                   __attribute__((section(".dtcm"))) = 0;  // Beeper samples made so far this batch
+s32 audio_tstates               __attribute__((section(".dtcm"))) = 0;  // When they were made
+s16 audio_ay[AUDIO_BATCH]       __attribute__((section(".dtcm")));
+s16 audio_beeper[AUDIO_BATCH]   __attribute__((section(".dtcm")));
+
+// Run the AY mixer on to sample 'upto' of the batch
+static inline void ay_run(u8 upto)
+{
+    if (upto <= ay_pos) return;
+    if (zx_AY_enabled)
+    {
+        if (audio_low) ay38910MixerLo(upto - ay_pos, &audio_ay[ay_pos], &myAY);
+        else ay38910Mixer(upto - ay_pos, &audio_ay[ay_pos], &myAY);
+    }
+    else memset(&audio_ay[ay_pos], 0x00, (upto - ay_pos) * sizeof(s16));
+    ay_pos = upto;
+}
+
+// ----------------------------------------------------------------------------------------
+// Replay the log - run the AY up to each write and make it. Anything logged for a sample
+// past 'upto' is made at 'upto' so that once we return the AY registers are all current.
+// ----------------------------------------------------------------------------------------
+static void ay_replay(u8 upto)
+{
+    for (u16 i=0; i<ay_log_len; i++)
+    {
+        AYWrite_t *w = &ay_log[i];
+        ay_run((w->sample < upto) ? w->sample : upto);
+        if (w->data) ay38910DataW(w->value, &myAY);
+        else ay38910IndexW(w->value, &myAY);
+    }
+    ay_log_len = 0;
+    ay_run(upto);
+}
+
+// ----------------------------------------------------------------------------------------
+// Called by the OUT handler for the AY register index (data=0) and register (data=1). The
+// first sample made by the next processDirectAudio() covers the quarter line after the last
+// call so a write later than that lands on the second.
+// ----------------------------------------------------------------------------------------
+ITCM_CODE void ay_write(u8 data, u8 value)
+{
+    s32 period = audio_period();
+    u8  late   = (((s32)CPU.TStates - audio_tstates) >= period) ? 1:0;
+
+    if (snd7)   // Off to the ARM7 AY - and into ours now for the Z80 to read back
+    {
+        snd7_post_samples();
+        snd7_post(SND7_AY | (data << 9) | (late << 8) | value);
+        if (data) {ay38910DataW(value, &myAY); snd7_regs[myAY.ayRegIndex] = myAY.ayRegs[myAY.ayRegIndex];}
+        else {ay38910IndexW(value, &myAY); snd7_index = myAY.ayRegIndex;}
+        return;
+    }
+
+    if (ay_log_len == AY_LOG) ay_replay(audio_len);     // No samples being made (tape) - just keep up
+
+    AYWrite_t *w = &ay_log[ay_log_len++];
+    w->sample = audio_len + late;
+    w->data   = data;
+    w->value  = value;
+}
+
+// Reading an AY register must see every write made so far - so catch the AY up to now
+ITCM_CODE u8 ay_read(void)
+{
+    if (ay_log_len) ay_replay(audio_len);
+    return ay38910DataR(&myAY);
+}
+
+// ----------------------------------------------------------------------------------------
+// The batch is done - run the AY over it and mix it with the beeper into the sample ring
+// ----------------------------------------------------------------------------------------
+static void audio_flush(void)
+{
+    ay_replay(audio_len);
+
+    for (u8 i=0; i<audio_len; i++)
+    {
+        if (((mixer_write+1)&WAVE_DIRECT_BUF_SIZE) == mixer_read) {mixer_overruns++; break;}
+        mixer[mixer_write] = audio_ay[i] + audio_beeper[i];
+        mixer_write++; mixer_write &= WAVE_DIRECT_BUF_SIZE;
+    }
+
+    audio_len = 0;
+    ay_pos = 0;
+}
+
+// The Z80 T-state counter is about to go back by 'tstates' (end of frame) - finish the batch and follow it
+void audio_frame_end(u32 tstates)
+{
+    if (snd7)
+    {
+        snd7_post_samples();
+        snd7_ay_sync(0);
+        snd7_post(SND7_FLUSH);
+    }
+    else audio_flush();
+    audio_tstates -= tstates;
+    beeper_clock -= tstates;
+    for (u8 i=0; i<beeper_log_len; i++) beeper_log[i].tstates -= tstates;
+}
+
+// --------------------------------------------------------------------------------------------
+// This is called when we want to sample the audio directly - twice a scanline for 2 samples
+// each time so one sample is a quarter of a line of T-states (or 1 sample of half a line at
+// the LOW sound quality). The beeper edges logged since the last call go into the ring first
+// and then the oldest beeper samples come out of it into the batch. The AY samples to go with
+// them are made when the batch is full.
+// --------------------------------------------------------------------------------------------
+ITCM_CODE void processDirectAudio(void)
+{
+    s32 period  = audio_period();
+    u32 recip   = audio_recip();
+    u8  samples = audio_low ? 1:2;
+
+    s32 ahead = (s32)CPU.TStates - beeper_clock;
+    if ((ahead < (BEEPER_LAG-2)*period) || (ahead > (BEEPER_LAG+3)*period)) beeper_sync(period);
+
+    if (snd7)   // The edges are already with the ARM7 - just count the samples
+    {
+        if (snd7_lost) snd7_resync();
+        beeper_log_len = 0;
+        beeper_clock += samples*period;
+        audio_tstates = CPU.TStates;
+        snd7_samples += samples;
+        if (snd7_samples >= AUDIO_BATCH) snd7_post_samples();
+        return;
+    }
+
+    for (u8 i=0; i<beeper_log_len; i++)
+    {
+        beeper_step((s32)beeper_log[i].tstates - beeper_clock, beeper_log[i].delta, period, recip);
+    }
+    beeper_log_len = 0;
+
+    for (u8 i=0; i<samples; i++)
+    {
+        beeper_level += beeper_ring[beeper_pos];
+        beeper_ring[beeper_pos] = 0;
+        beeper_pos = (beeper_pos + 1) & (BEEPER_RING-1);
+        beeper_clock += period;
+        audio_beeper[audio_len++] = beeper_level >> BEEPER_SHIFT;
+    }
+    audio_tstates = CPU.TStates;
+
+    if (audio_len >= AUDIO_BATCH) audio_flush();
+}
+
+void sound_chip_reset()
+{
+  memset(mixer,   0x00, sizeof(mixer));
+  mixer_read=0;
+  mixer_write=0;
+
+  //  --------------------------------------------------------------------
+  //  The AY sound chip is for the ZX Spectrum 128K
+  //  --------------------------------------------------------------------
+  ay38910Reset(&myAY);             // Reset the "AY" sound chip
+  ay38910IndexW(0x07, &myAY);      // Register 7 is ENABLE
+  ay38910DataW(0x3F, &myAY);       // All OFF (negative logic)
+  ay38910Mixer(4, audio_ay, &myAY);// Do an initial mix conversion to clear the output
+
+  memset(audio_ay, 0x00, sizeof(audio_ay));
+  ay_log_len = 0;
+  ay_pos = audio_len = 0;
+
+  if (snd7)
+  {
+      snd7_samples = 0;
+      snd7_post(SND7_RESET | audio_low);
+      snd7_ay_sync(1);
+  }
+
+  beeper_sync(audio_period());
+}
+
+// --------------------------------------------------------------------------------------------
+// Hand the mixing to the ARM7 to play this many sample pairs a second - it is sent where the
+// ring is and starts its own AY from ours. And take it back again, carrying on from our AY.
+// --------------------------------------------------------------------------------------------
+void sound_arm7_start(u32 rate)
+{
+    if (!snd7)
+    {
+        memset(&snd7_share, 0x00, sizeof(snd7_share));
+#ifdef HOST_BUILD
+        snd7 = &snd7_share;
+#else
+        DC_FlushRange(&snd7_share, sizeof(snd7_share));
+        snd7 = (SoundShare_t *)memUncached(&snd7_share);
+        fifoSendAddress(FIFO_USER_01, &snd7_share);
+#endif
+    }
+
+    snd7->pause = soundEmuPause;
+    snd7_samples = 0;
+    snd7_lost = 0;
+    snd7_post(SND7_RESET | audio_low);
+    snd7_ay_sync(1);
+    beeper_sync(audio_period());
+    snd7->rate = rate;
+}
+
+void sound_arm7_stop(void)
+{
+    if (!snd7) return;
+    snd7->rate = 0;
+    snd7 = NULL;
+
+    ay_log_len = 0;
+    ay_pos = audio_len = 0;
+    beeper_sync(audio_period());
+}
+
+// --------------------------------------------------------------------------------------------
+// The LOW sound quality makes half as many samples - one each half scanline - for the stream
+// to play at half the rate. The beeper steps are band-limited to whatever the rate is and the
+// AY mixer takes two chip ticks for each pass of its loop so the AY is half the work as well.
+// That is 15.4KHz, a little under 16KHz, but it keeps the samples on the scanline grid.
+// Whatever is in the batch is finished at the old rate first.
+// --------------------------------------------------------------------------------------------
+void sound_set_quality(u8 low)
+{
+    if (low == audio_low) return;
+    if (!snd7) audio_flush();
+    audio_low = low;
+    beeper_sync(audio_period());
+}
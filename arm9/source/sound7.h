@@ -0,0 +1,96 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+#ifndef _SOUND7_H_
+#define _SOUND7_H_
+
+// ---------------------------------------------------------------------------------
+// Shared by sound.c on the ARM9 and emusoundfifo.c on the ARM7 - the beeper step
+// table and the command ring the ARM9 fills when the ARM7 is doing the mixing.
+// ---------------------------------------------------------------------------------
+#include <nds/ndstypes.h>
+
+#define BEEPER_VOLUME   0xA00   // Speaker on (off is zero) - the same level as ever
+#define BEEPER_SHIFT    15      // Each row of the step table adds up to 1 << BEEPER_SHIFT
+#define BEEPER_PHASES   32
+#define BEEPER_TAPS     8
+#define BEEPER_RING     32      // Must be a power of 2 and well clear of the taps plus the lag
+
+// --------------------------------------------------------------------------------------------
+// The band-limited impulse for an edge which falls at phase/32 of the way between two samples.
+// Tap j lands on the sample (j-3) after the one before the edge. Blackman windowed sinc with
+// the cutoff at 90% of the Nyquist frequency - each row then scaled to add up to exactly 32768
+// so the steps always integrate back to exactly BEEPER_VOLUME and the level never wanders.
+// --------------------------------------------------------------------------------------------
+static const s16 beeper_blep[BEEPER_PHASES][BEEPER_TAPS] =
+{
+    {   187,  -1042,   2493,  29492,   2493,  -1042,    187,      0},
+    {   160,   -865,   1723,  29446,   3315,  -1226,    215,      0},
+    {   135,   -697,   1006,  29310,   4187,  -1416,    244,     -1},
+    {   112,   -538,    344,  29082,   5105,  -1610,    274,     -1},
+    {    91,   -390,   -263,  28767,   6067,  -1806,    304,     -2},
+    {    72,   -252,   -813,  28364,   7069,  -2003,    335,     -4},
+    {    55,   -126,  -1307,  27876,   8107,  -2197,    365,     -5},
+    {    39,    -12,  -1746,  27312,   9176,  -2388,    394,     -7},
+    {    26,     90,  -2130,  26668,  10272,  -2571,    422,     -9},
+    {    15,    181,  -2461,  25951,  11390,  -2744,    447,    -11},
+    {     5,    260,  -2739,  25166,  12524,  -2905,    470,    -13},
+    {    -2,    327,  -2967,  24318,  13668,  -3051,    490,    -15},
+    {    -9,    383,  -3147,  23414,  14817,  -3178,    505,    -17},
+    {   -13,    429,  -3281,  22455,  15964,  -3283,    515,    -18},
+    {   -17,    464,  -3372,  21454,  17103,  -3363,    519,    -20},
+    {   -19,    490,  -3423,  20410,  18228,  -3415,    517,    -20},
+    {   -20,    508,  -3436,  19333,  19331,  -3436,    508,    -20},
+    {   -20,    517,  -3415,  18228,  20410,  -3423,    490,    -19},
+    {   -20,    519,  -3363,  17103,  21454,  -3372,    464,    -17},
+    {   -18,    515,  -3283,  15964,  22455,  -3281,    429,    -13},
+    {   -17,    505,  -3178,  14817,  23414,  -3147,    383,     -9},
+    {   -15,    490,  -3051,  13668,  24318,  -2967,    327,     -2},
+    {   -13,    470,  -2905,  12524,  25166,  -2739,    260,      5},
+    {   -11,    447,  -2744,  11390,  25951,  -2461,    181,     15},
+    {    -9,    422,  -2571,  10272,  26668,  -2130,     90,     26},
+    {    -7,    394,  -2388,   9176,  27312,  -1746,    -12,     39},
+    {    -5,    365,  -2197,   8107,  27876,  -1307,   -126,     55},
+    {    -4,    335,  -2003,   7069,  28364,   -813,   -252,     72},
+    {    -2,    304,  -1806,   6067,  28767,   -263,   -390,     91},
+    {    -1,    274,  -1610,   5105,  29082,    344,   -538,    112},
+    {    -1,    244,  -1416,   4187,  29310,   1006,   -697,    135},
+    {     0,    215,  -1226,   3315,  29446,   1723,   -865,    160},
+};
+
+// ---------------------------------------------------------------------------------
+// With the SOUND CPU option on ARM7, the ARM9 makes no samples at all. It posts what
+// the Z80 did to the sound hardware into this ring (in main RAM) and the ARM7 runs
+// the AY and the beeper steps from it - in the same batches and with the same log
+// replay as sound.c - straight into a looping hardware sound channel. Each entry is
+// a command in the top 4 bits with its argument below.
+// ---------------------------------------------------------------------------------
+#define SND7_RING           4096            // Entries - must be a power of 2
+
+#define SND7_SAMPLES        0x00000000      // Make this many more samples (low 16 bits)
+#define SND7_AY             0x10000000      // Bit 9: 0=index 1=register, bit 8: a sample late, bits 0-7: value
+#define SND7_BEEPER         0x20000000      // Bit 10: speaker on, bits 5-9: samples ahead, bits 0-4: phase
+#define SND7_SYNC           0x30000000      // Empty the beeper steps and set the speaker (bit 0)
+#define SND7_FLUSH          0x40000000      // End of frame - finish the batch
+#define SND7_AY_ENABLE      0x50000000      // Bit 0: the AY is there to be heard
+#define SND7_RESET          0x60000000      // Reset the AY and drop anything not yet mixed - bit 0: LOW sound quality
+#define SND7_CMD_MASK       0xF0000000
+
+typedef struct
+{
+    vu16 head;                  // Next entry the ARM9 writes
+    vu16 tail;                  // Next entry the ARM7 reads
+    vu32 rate;                  // Pairs of samples a second - zero when the ARM9 is mixing
+    vu8  pause;                 // Hold the last sample (menus, loading) but keep reading
+    u8   unused[3];
+    vu32 ring[SND7_RING];
+} SoundShare_t;
+
+#endif // _SOUND7_H_
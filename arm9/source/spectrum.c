@@ -21,6 +21,7 @@
 #include "CRC32.h"
 #include "cpu/z80/Z80_interface.h"
 #include "SpeccyUtils.h"
+#include "render.h"
 #include "printf.h"
 
 u8  portFE               __attribute__((section(".dtcm"))) = 0x00;
@@ -33,12 +34,128 @@ u8  zx_128k_mode         __attribute__((section(".dtcm"))) = 0;
 u8  zx_ScreenRendering   __attribute__((section(".dtcm"))) = 0;
 u8  zx_force_128k_mode   __attribute__((section(".dtcm"))) = 0;
 u32 zx_current_line      __attribute__((section(".dtcm"))) = 0;
-u8  zx_contend_delay     __attribute__((section(".dtcm"))) = 0;
+u32 zx_contend_base     __attribute__((section(".dtcm"))) = 0;
 u8  zx_special_key       __attribute__((section(".dtcm"))) = 0;
 u32 last_file_size       __attribute__((section(".dtcm"))) = 0;
 u8  isCompressed         __attribute__((section(".dtcm"))) = 1;
 u8  tape_play_skip_frame __attribute__((section(".dtcm"))) = 0;
-u8  backgroundRenderScreen = 0;
+u8  backgroundRenderScreen = 0;  // 0x80 | screen buffer to be shown at the next vblank
+
+// ------------------------------------------------------------------------------------------
+// Memory contention by 16K slot of the Z80 address space. zx_contend_pages[] holds a mask
+// for each slot that the ULA shares with the CPU (0x4000 always, 0xC000 if an odd 128K bank
+// is paged in) and is rebuilt whenever the paging changes. zx_contend_table[] is what the
+// CPU core actually applies - a copy of the above while the screen is being rendered and
+// all zeros otherwise - so each access costs just a couple of table loads and an add.
+// ------------------------------------------------------------------------------------------
+u8  zx_contend_pages[4]  __attribute__((section(".dtcm"))) __attribute__((aligned(4))) = {0,0,0,0};
+u8  zx_contend_table[4]  __attribute__((section(".dtcm"))) __attribute__((aligned(4))) = {0,0,0,0};
+
+// ------------------------------------------------------------------------------------------
+// The ULA contention pattern for one screen line indexed by the T-state relative to the
+// start of contention on that line (zx_contend_base). The ULA fetches for 128 T-states in
+// groups of 8 with a 6,5,4,3,2,1,0,0 delay and then sits idle for the border and retrace.
+// The index is taken as a u8 so any access outside the fetch window lands on a zero and
+// the table is small enough to live in fast memory - the 48K and 128K machines differ only
+// in line length and where contention begins, which is handled by zx_contend_base.
+// ------------------------------------------------------------------------------------------
+u8  zx_ula_contend[256]  __attribute__((section(".dtcm"))) __attribute__((aligned(4))) = {0};
+
+// ------------------------------------------------------------------------------------------
+// Dirty scanline tracking. WrZ80() marks a pixel row in zx_dirty_rows[] whenever a byte of
+// the displayed screen page changes (an attribute byte marks all 8 rows of its character
+// row) and speccy_render_screen_line() only redraws rows that are marked. There is one bit
+// per screen buffer since the DSi rotates between two or three of them and each one has to
+// catch up on what changed while it was away. zx_screen_slot[] is a mask for each 16K slot
+// of the Z80 address space which maps the displayed screen page so WrZ80() can tell cheaply.
+// ------------------------------------------------------------------------------------------
+u8  zx_screen_slot[4]    __attribute__((section(".dtcm"))) __attribute__((aligned(4))) = {0,0,0,0};
+u8  zx_dirty_rows[192]   __attribute__((section(".dtcm"))) __attribute__((aligned(4))) = {0};
+
+// ------------------------------------------------------------------------------------------
+// Rendering by frame. Rather than drawing each screen line as the beam reaches it, WrZ80()
+// logs every change to the displayed screen page with its T-state and the whole frame is
+// drawn in one pass at the end by replaying those writes against zx_beam_screen[] (the
+// screen as the ULA saw it when the frame began). A write that lands in the middle of a
+// line is applied at the character cell the ULA was fetching so multicolour effects show
+// as they would on the real machine. If the log overflows or the screen changes in a way
+// that isn't logged, we resync from the screen page and draw the frame as it ended.
+// ------------------------------------------------------------------------------------------
+#define ZX_BEAM_LOG_SIZE 8192
+
+typedef struct
+{
+    u32 tstates;
+    u16 offset;
+    u8  value;
+    u8  unused;
+} BeamWrite_t;
+
+u8  zx_beam_render       __attribute__((section(".dtcm"))) = 0;
+u8  zx_beam_resync       __attribute__((section(".dtcm"))) = 1;
+u32 zx_beam_log_len      __attribute__((section(".dtcm"))) = 0;
+BeamWrite_t zx_beam_log[ZX_BEAM_LOG_SIZE];
+u8  zx_beam_screen[0x1B00] __attribute__((aligned(4)));
+
+ITCM_CODE void zx_beam_log_write(u32 tstates, word offset, u8 value)
+{
+    if (zx_beam_log_len < ZX_BEAM_LOG_SIZE)
+    {
+        BeamWrite_t *w = &zx_beam_log[zx_beam_log_len++];
+        w->tstates = tstates;
+        w->offset  = offset;
+        w->value   = value;
+    }
+    else zx_beam_resync = 1;
+}
+
+// Any change that can't be tracked by row (paging in a new screen, loading a state, POKEs)
+void zx_screen_dirty_all(void)
+{
+    memset(zx_dirty_rows, ZX_DIRTY_ALL, sizeof(zx_dirty_rows));
+    zx_beam_resync = 1;
+}
+
+static inline u8 *zx_screen_page(void)
+{
+    if (zx_128k_mode) return RAM_Memory128 + ((portFD & 0x08) ? 7:5) * 0x4000;
+    return RAM_Memory + 0x4000;
+}
+
+void zx_screen_rebuild(void)
+{
+    u8 *page = zx_screen_page();
+    for (int i=0; i<4; i++) zx_screen_slot[i] = (MemoryMap[i] == page) ? 0xFF:0x00;
+}
+
+// ------------------------------------------------------------------------------------------
+// Contention on the next screen line starts 1 (48K) or 3 (128K) T-states before the line
+// itself. This is only set as a line finishes in speccy_run() (and when a snapshot or state
+// is loaded) - never from zx_bank() as the line being run would then be a whole line off.
+// ------------------------------------------------------------------------------------------
+void zx_contend_set_base(void)
+{
+    zx_contend_base = (zx_current_line * (zx_128k_mode ? 228:224)) - (zx_128k_mode ? 3:1);
+}
+
+void zx_contend_rebuild(void)
+{
+    zx_contend_pages[0] = 0x00;                                             // ROM is never contended
+    zx_contend_pages[1] = 0xFF;                                             // Screen memory (bank 5) is always contended
+    zx_contend_pages[2] = 0x00;                                             // Bank 2 is never contended
+    zx_contend_pages[3] = (zx_128k_mode && (portFD & 1)) ? 0xFF:0x00;       // For the ZX 128K, odd banks (1,3,5,7) are contended
+
+    if (zx_ScreenRendering) memcpy(zx_contend_table, zx_contend_pages, 4);
+    else memset(zx_contend_table, 0x00, 4);
+}
+
+// Turn the ULA screen fetch (and with it the memory contention) on or off
+static inline void zx_set_rendering(u8 rendering)
+{
+    zx_ScreenRendering = rendering;
+    if (rendering) memcpy(zx_contend_table, zx_contend_pages, 4);
+    else memset(zx_contend_table, 0x00, 4);
+}
 
 ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
 {
@@ -48,13 +165,11 @@ ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
     {        
           // ----------------------------------------------------------------------------------------
           // If we are rendering the screen, a read from the ULA supplied port will produce
-          // a cycle penalty. This is not cycle accurate but we simply use an 'average'
-          // penalty of 4 cycles if we are in contended memory while the screen is rendering. It's
-          // rough but gets us close enough to play games. We can improve this later...
+          // a cycle penalty. We look up the real ULA delay for where we are in the scanline.
           // ----------------------------------------------------------------------------------------
           if (zx_ScreenRendering)
           {
-              CPU.TStates += zx_contend_delay; 
+              CPU.TStates += zx_ula_contend[(u8)(CPU.TStates - zx_contend_base)];
           }
 
         
@@ -229,7 +344,7 @@ ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
     else
     if ((Port & 0xc002) == 0xc000) // AY input
     {
-        return ay38910DataR(&myAY);
+        return ay_read();
     }
     
     // ---------------------------------------------------------------------------------------------
@@ -255,6 +370,71 @@ ITCM_CODE unsigned char cpu_readport_speccy(register unsigned short Port)
     return 0xFF;  // Unused port returns 0xFF when ULA is idle
 }
 
+// ------------------------------------------------------------------------------------------
+// Idle loop detection. Many games wait for the next frame not with a HALT but by spinning
+// on a frame counter the interrupt handler updates - something like LD A,(nn) / AND A /
+// JR Z,loop. The CPU core calls this on any short backwards JR that is taken. If every
+// instruction in the loop only reads memory and sets A or the flags the same way on each
+// pass, nothing but an interrupt can ever get us out of the loop and the core can skip
+// ahead just as it does for HALT. We remember the last loop that didn't qualify so that
+// busy delay loops (DEC BC / LD A,B / OR C / JR NZ) don't get decoded on every pass.
+// ------------------------------------------------------------------------------------------
+u32 zx_idle_skipped      __attribute__((section(".dtcm"))) = 0;   // T-states skipped this frame
+u32 zx_idle_last_frame   __attribute__((section(".dtcm"))) = 0;   // T-states skipped last frame (for the debugger)
+
+static inline u8 zx_peek(u16 A) {return *(MemoryMap[(A)>>14] + ((A)&0x3FFF));}
+
+ITCM_CODE u8 zx_idle_loop(u16 start, u16 jr)
+{
+    static u16 reject_start = 0xFFFF, reject_jr = 0xFFFF;
+
+    if (myConfig.idleLoop) return 0;                                // Per-game override - just run the loop
+    if ((start == reject_start) && (jr == reject_jr)) return 0;     // Already known not to be idle
+
+    u16 pc = start;
+    while (pc != jr)
+    {
+        u8 op = zx_peek(pc);
+        switch (op)
+        {
+            case 0x00:                      // NOP
+            case 0x0A: case 0x1A:           // LD A,(BC)  LD A,(DE)
+            case 0x7E:                      // LD A,(HL)
+            case 0xA0: case 0xA1: case 0xA2: case 0xA3: case 0xA4: case 0xA5: case 0xA6: case 0xA7: // AND r  AND (HL)
+            case 0xB0: case 0xB1: case 0xB2: case 0xB3: case 0xB4: case 0xB5: case 0xB6: case 0xB7: // OR r   OR (HL)
+            case 0xB8: case 0xB9: case 0xBA: case 0xBB: case 0xBC: case 0xBD: case 0xBE: case 0xBF: // CP r   CP (HL)
+                pc += 1;
+                break;
+            case 0xE6: case 0xF6: case 0xFE: // AND n  OR n  CP n
+                pc += 2;
+                break;
+            case 0x3A:                      // LD A,(nn)
+                pc += 3;
+                break;
+            case 0xCB:                      // BIT b,(HL)  BIT b,A
+                op = zx_peek(pc+1);
+                if (((op & 0xC0) != 0x40) || (((op & 7) != 6) && ((op & 7) != 7))) goto not_idle;
+                pc += 2;
+                break;
+            case 0xDD: case 0xFD:           // LD A,(IX+d)  CP (IX+d)  BIT b,(IX+d) and the IY forms
+                op = zx_peek(pc+1);
+                if ((op == 0x7E) || (op == 0xBE) || (op == 0xA6) || (op == 0xB6)) pc += 3;
+                else if ((op == 0xCB) && ((zx_peek(pc+3) & 0xC7) == 0x46)) pc += 4;
+                else goto not_idle;
+                break;
+            default:
+                goto not_idle;
+        }
+        if ((u16)(pc - start) > (u16)(jr - start)) goto not_idle;   // Ran past the JR - not a simple loop
+    }
+    return 1;
+
+not_idle:
+    reject_start = start;
+    reject_jr = jr;
+    return 0;
+}
+
 // --------------------------------------------------------------------------------------
 // For the ZX Spectrum 128K this is the banking routine that will swap the BIOS ROM and
 // swap out the bank of memory that will be visible at 0xC000 in CPU address space.
@@ -272,7 +452,12 @@ void zx_bank(u8 new_bank)
     // Map in the correct page of banked memory to 0xC000
     MemoryMap[3] = RAM_Memory128 + ((new_bank & 0x07) * 0x4000) + 0x0000;
 
+    if ((portFD ^ new_bank) & 0x08) zx_screen_dirty_all(); // Showing the other screen page
+
     portFD = new_bank;
+
+    zx_contend_rebuild();   // The bank at 0xC000 may have changed contention
+    zx_screen_rebuild();    // ...and so may where the screen page is visible
 }
 
 // A fast look-up table when we are rendering background pixels
@@ -288,17 +473,36 @@ u16 zx_border_colors[8] __attribute__((section(".dtcm"))) =
   (u16)RGB15(0xFD,0xFD,0xFD),   // White
 };
 
+// ------------------------------------------------------------------------------------------
+// Border colour by scanline. Rather than poking the palette on every OUT to port FE, the
+// border colour is noted at the end of every scanline in zx_border_line[] and at the end of
+// the frame the 192 lines alongside the screen are turned into palette colours. The vblank
+// handler then feeds those to BG_PALETTE_SUB[1] one line at a time with an HBlank DMA so
+// loading stripes and border effects show up. There are two tables so the one being shown
+// is never the one being filled. zx_border_frames counts down the vblanks that may still
+// use the table - it keeps the DMA going while the emulation runs slower than the display.
+// ------------------------------------------------------------------------------------------
+u8  zx_border_line[312]  __attribute__((section(".dtcm"))) = {0};
+u16 zx_border_rgb[2][ZX_BORDER_DS_LINES+1] __attribute__((aligned(32)));
+u16 *zx_border_show = zx_border_rgb[0];
+u8  zx_border_frames = 0;
+
+static void zx_border_frame(void)
+{
+    u16 *rgb = (zx_border_show == zx_border_rgb[0]) ? zx_border_rgb[1] : zx_border_rgb[0];
+    for (int y=0; y<ZX_BORDER_DS_LINES; y++) rgb[y] = zx_border_colors[zx_border_line[y+64]];
+    rgb[ZX_BORDER_DS_LINES] = rgb[ZX_BORDER_DS_LINES-1]; // The HBlank DMA also fires after the last line
+    zx_border_show = rgb;
+    zx_border_frames = 4;
+}
+
 
 ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsigned char Value)
 {
     if ((Port & 1) == 0) // Any even port (usually 0xFE) is our ULA and beeper output
     {
-        // Change the background color as needed...
-        if ((portFE & 0x07) != (Value & 0x07))
-        {
-             BG_PALETTE_SUB[1] = zx_border_colors[Value & 0x07];
-        }
-        portFE = Value;        
+        if ((Value ^ portFE) & 0x10) beeper_edge(CPU.TStates, Value & 0x10);  // The speaker moved (see processDirectAudio)
+        portFE = Value;     // The border colour is picked up at the end of the scanline (see zx_border_line[])
     }
     
     if (zx_128k_mode && ((Port & 0x8002) == 0x0000)) // 128K Bankswitch
@@ -308,55 +512,154 @@ ITCM_CODE void cpu_writeport_speccy(register unsigned short Port,register unsign
     else
     if ((Port & 0xc002) == 0xc000) // AY Register Select
     {
-        ay38910IndexW(Value&0xF, &myAY);
+        ay_write(0, Value&0xF);     // Logged and made when the AY samples are (see sound.c)
         zx_AY_index_written = 1;
     }
     else if ((Port & 0xc002) == 0x8000) // AY Data Write
     {
-        ay38910DataW(Value, &myAY);
+        ay_write(1, Value);
         if (zx_AY_index_written) zx_AY_enabled = 1;
     }
 }
 
-// A fast look-up table when we are rendering background pixels
-u32 zx_colors_extend32[16] __attribute__((section(".dtcm"))) =
+// ----------------------------------------------------------------------------
+// Screen buffers. The top screen shows one of up to three 256x192 bitmaps at
+// 0x06000000 + 64K * buffer and the vblank handler flips between them just by
+// pointing BG3 at the buffer held in backgroundRenderScreen - nothing is ever
+// copied. The DS-Lite/Phat only has the one buffer which is drawn directly.
+// The DSi draws each frame into a buffer that isn't being shown and hands it
+// over when the frame is done. With three buffers there is always one free to
+// draw into - with two, a frame still waiting to be shown is drawn over.
+// ----------------------------------------------------------------------------
+u8  zx_video_buffers = 1;   // How many screen buffers (set up in spectrumInit)
+u8  zx_video_show    = 0;   // The buffer on screen right now (changed at vblank)
+u8  zx_video_draw    = 0;   // The buffer we are drawing this frame into
+u8  zx_video_drawing = 0;   // Set once a whole frame is going into zx_video_draw
+
+static inline u8 zx_video_next(void)
 {
-    0x00000000, 0x01010101, 0x02020202, 0x03030303,
-    0x04040404, 0x05050505, 0x06060606, 0x07070707,
-    0x08080808, 0x09090909, 0x0A0A0A0A, 0x0B0B0B0B,
-    0x0C0C0C0C, 0x0D0D0D0D, 0x0E0E0E0E, 0x0F0F0F0F
-};
+    u8 ready = zx_video_show;
+
+    int oldIME = enterCriticalSection();
+    if (backgroundRenderScreen)
+    {
+        ready = backgroundRenderScreen & 0x03;
+        if (zx_video_buffers < 3) backgroundRenderScreen = 0; // No free buffer - that frame is dropped and drawn over
+    }
+    leaveCriticalSection(oldIME);
+
+    for (u8 buf=0; buf<zx_video_buffers; buf++)
+    {
+        if ((buf != zx_video_show) && (buf != ready)) return buf;
+    }
+    return ready;
+}
+
+// At the end of a frame, hand over the buffer we've drawn to be shown at the next vblank
+static inline void zx_video_frame_done(void)
+{
+    render_line_wait();     // The last line may still be on its way to VRAM
+    if (zx_video_drawing) backgroundRenderScreen = 0x80 | zx_video_draw;
+}
 
 // ----------------------------------------------------------------------------
-// Render one screen line of pixels. This is called on every visible scanline
-// and is heavily optimized to draw as fast as possible. Since the screen is
-// often drawing background (paper vs ink), that's handled via look-up table.
+// Adaptive frameskip. After every frame the main loop tells speccy_frameskip()
+// how long the frame took and how long it had (both in TIMER2 ticks). We keep
+// a running average for frames drawn and frames skipped and, once per cycle
+// of one drawn and zx_frame_skip skipped frames, see if the cycle fits in its
+// time. Over budget for a couple of cycles and we skip another frame - well
+// under budget (7/8ths) with one frame fewer skipped for a while and we draw
+// one more. The per-game options bound the level between a min and a max.
 // ----------------------------------------------------------------------------
-u8 bRenderSkipOnce = 1;
-ITCM_CODE void speccy_render_screen_line(u8 line)
+#define FRAMESKIP_LEVELS    4   // 0 = draw every frame up to 3 = draw 1 in 4
+#define FRAMESKIP_UP        2   // Cycles over budget before we skip more frames
+#define FRAMESKIP_DOWN      16  // Cycles with time to spare before we skip fewer
+
+u8  zx_frame_skip    = 0;   // Frames skipped after each one drawn
+u8  zx_frame_render  = 1;   // Are we drawing the current frame?
+u8  zx_frame_count   = 0;   // Where we are in the cycle of drawn and skipped frames
+u16 zx_busy_drawn    = 0;   // Average TIMER2 ticks for a frame that was drawn...
+u16 zx_busy_skipped  = 0;   // ...and for a frame that wasn't
+u8  zx_skip_late     = 0;
+u8  zx_skip_early    = 0;
+
+static inline u8 zx_frameskip_min(void) {return myConfig.frameSkipMin;}
+static inline u8 zx_frameskip_max(void)
+{
+    u8 max = (FRAMESKIP_LEVELS-1) - myConfig.frameSkipMax;    // The option is stored so that 0 is the default of 3
+    return (max < myConfig.frameSkipMin) ? myConfig.frameSkipMin : max;
+}
+
+void speccy_frameskip_reset(void)
+{
+    zx_frame_skip = zx_frameskip_min();
+    zx_frame_count = 0;
+    zx_busy_drawn = zx_busy_skipped = 0;
+    zx_skip_late = zx_skip_early = 0;
+}
+
+void speccy_frameskip(u32 busy, u32 budget)
+{
+    if (tape_is_playing()) return;              // The tape has its own rule (see below)
+    if (busy > 2*budget) busy = 2*budget;       // Don't let one long frame (menus, disk) swamp the average
+
+    if (zx_frame_render) zx_busy_drawn = (zx_busy_drawn * 3 + busy) / 4;
+    else zx_busy_skipped = (zx_busy_skipped * 3 + busy) / 4;
+
+    if (zx_frame_count) return;                 // Only judge a whole cycle
+
+    u8 lo = zx_frameskip_min();
+    u8 hi = zx_frameskip_max();
+
+    u32 need = zx_busy_drawn + (zx_frame_skip * zx_busy_skipped);
+    if ((zx_frame_skip < hi) && (need > (zx_frame_skip+1) * budget))
+    {
+        zx_skip_early = 0;
+        if (++zx_skip_late >= FRAMESKIP_UP) {zx_frame_skip++; zx_skip_late = 0;}
+    }
+    else if ((zx_frame_skip > lo) && ((zx_busy_drawn + ((zx_frame_skip-1) * zx_busy_skipped)) * 8 <= zx_frame_skip * budget * 7))
+    {
+        zx_skip_late = 0;
+        if (++zx_skip_early >= FRAMESKIP_DOWN) {zx_frame_skip--; zx_skip_early = 0;}
+    }
+    else zx_skip_late = zx_skip_early = 0;
+
+    if (zx_frame_skip < lo) zx_frame_skip = lo; // The options may have changed under us
+    if (zx_frame_skip > hi) zx_frame_skip = hi;
+}
+
+// ----------------------------------------------------------------------------
+// Work out where a screen line is to be drawn - or NULL if it needn't be drawn
+// at all this frame. Line 0 also handles the flashing 'timer' and picks the
+// buffer the DSi is going to draw this frame into.
+// ----------------------------------------------------------------------------
+static inline u32 *zx_render_target(u8 line)
 {
-    u32 *vidBuf;
-    u8 *zx_ScreenPage = 0;
+    u8 dirty_bit;
 
     if (line == 0) // At start of each new frame, handle the flashing 'timer'
     {
-        if (isDSiMode() && !tape_is_playing()) // For the DSi we can double-buffer and draw the screen in the background
+        zx_frame_render = (zx_frame_count == 0);
+        zx_frame_count = (zx_frame_count >= zx_frame_skip) ? 0 : zx_frame_count+1;
+
+        zx_video_drawing = 0;
+        if (isDSiMode() && zx_frame_render && !tape_is_playing()) // For the DSi we can draw the screen in the background
         {
-            if (bRenderSkipOnce) bRenderSkipOnce=0;
-            else backgroundRenderScreen = 0x80 | (flash_timer & 1);
+            zx_video_draw = zx_video_next();
+            zx_video_drawing = 1;
         }
         tape_play_skip_frame++;
-        if (++flash_timer & 0x10) {flash_timer=0; bFlash ^= 1;} // Same timing as real ULA - 16 frames on and 16 frames off
+        if (++flash_timer & 0x10) {flash_timer=0; bFlash ^= 1; memset(zx_dirty_rows, ZX_DIRTY_ALL, sizeof(zx_dirty_rows));} // Same timing as real ULA - 16 frames on and 16 frames off
     }
     
-    if (isDSiMode() && !tape_is_playing())
+    if (zx_video_drawing)
     {
-        vidBuf = (u32*) ((flash_timer & 1 ? 0x06820000:0x06830000) + (line << 8));    // Video buffer... write 32-bits at a time for maximum speed
+        dirty_bit = ZX_DIRTY_BUF(zx_video_draw);
     }
     else // For the DS-Lite/Phat we direct render for speed - also when tape is loading...
     {
-        vidBuf = (u32*)(0x06000000 + (line << 8));    // Video buffer... write 32-bits at a time for maximum speed
-        bRenderSkipOnce = 1; // When we stop the tape, we want to allow the first frame to re-draw before rendering
+        zx_video_draw = zx_video_show;
+        dirty_bit = tape_is_playing() ? 0:ZX_DIRTY_BUF(zx_video_draw); // Redraw it all for the tape as it's only now and again
     }
     
     // -----------------------------------------------------------------------------
@@ -366,65 +669,126 @@ ITCM_CODE void speccy_render_screen_line(u8 line)
     // -----------------------------------------------------------------------------
     if (tape_is_playing())
     {
-        if (tape_play_skip_frame & 0x1F) return; 
+        if (tape_play_skip_frame & 0x1F) return NULL; 
     }
-    
-    // -----------------------------------------------------------
-    // For DS-Lite/Phat, we draw every other frame to gain speed.
-    // -----------------------------------------------------------
-    if (!isDSiMode() && (flash_timer & 1)) return;
-
-    // -----------------------------------------------------------------------
-    // Render the current line into our NDS video memory. For the ZX 128K, we 
-    // might be using page 7 for video display... it's rare, but possible...
-    // -----------------------------------------------------------------------
-    if (zx_128k_mode) zx_ScreenPage = RAM_Memory128 + ((portFD & 0x08) ? 7:5) * 0x4000;
-    else zx_ScreenPage = RAM_Memory + 0x4000;
-
-    // ----------------------------------------------------------------
-    // The color attribute is stored independently from the pixel data
-    // ----------------------------------------------------------------
-    u8 *attrPtr = &zx_ScreenPage[0x1800 + ((line/8)*32)];
-    word offset = ((line&0x07) << 8) | ((line&0x38) << 2) | ((line&0xC0) << 5);
-    u8 *pixelPtr = zx_ScreenPage+offset;
-    
-    // ---------------------------------------------------------------------
-    // With 8 pixels per byte, there are 32 bytes of horizontal screen data
-    // ---------------------------------------------------------------------
-    for (int x=0; x<32; x++)
+    else if (!zx_frame_render) return NULL; // Otherwise the frameskip controller decides (see speccy_frameskip)
+
+    // -------------------------------------------------------------------
+    // Nothing on this row has changed since we last drew it into this
+    // video buffer - so there is nothing to do (see zx_dirty_rows[]).
+    // -------------------------------------------------------------------
+    if (dirty_bit)
     {
-        u8 attr = *attrPtr++;           // The color attribute and possible flashing
-        u8 paper = ((attr>>3) & 0x0F);  // Paper is the background
-        u8 pixel = *pixelPtr++;         // And here is 8 pixels to draw
+        if ((zx_dirty_rows[line] & dirty_bit) == 0) return NULL;
+        zx_dirty_rows[line] &= ~dirty_bit;
+    }
 
-        if (attr & 0x80) // Flashing swaps pen/ink
-        {
-            if (bFlash) pixel = ~pixel; // Faster to just invert the pixel itself...
-        }
-        
-        // --------------------------------------------------------------------------
-        // And now the pixel drawing... We try to speed this up as much as possible.
-        // --------------------------------------------------------------------------
-        if (pixel) // Is at least one pixel on?
-        {
-            u8 ink   = (attr & 0x07);       // Ink Color is the foreground
-            if (attr & 0x40) ink |= 0x08;   // Brightness
-
-            // ------------------------------------------------------------------------------------------------------------------------
-            // I've tried look-up tables here, but nothing was as fast as checking the bit and shifting ink/paper to the right spot...
-            // ------------------------------------------------------------------------------------------------------------------------
-            *vidBuf++ = (((pixel & 0x80) ? ink:paper)) | (((pixel & 0x40) ? ink:paper) << 8) | (((pixel & 0x20) ? ink:paper) << 16) | (((pixel & 0x10) ? ink:paper) << 24);
-            *vidBuf++ = (((pixel & 0x08) ? ink:paper)) | (((pixel & 0x04) ? ink:paper) << 8) | (((pixel & 0x02) ? ink:paper) << 16) | (((pixel & 0x01) ? ink:paper) << 24);
-        }
-        else // Just drawing all background which is common...
+    return (u32*)(ZX_VIDEO_BUFFER(zx_video_draw) + (line << 8));  // Video buffer... write 32-bits at a time for maximum speed
+}
+
+// The pixel data for a screen line is interleaved in thirds of the screen
+static inline word zx_line_offset(u8 line)
+{
+    return ((line&0x07) << 8) | ((line&0x38) << 2) | ((line&0xC0) << 5);
+}
+
+// ----------------------------------------------------------------------------
+// Render one screen line of pixels. This is called on every visible scanline
+// when we are rendering line by line.
+// ----------------------------------------------------------------------------
+ITCM_CODE void speccy_render_screen_line(u8 line)
+{
+    u32 *vidBuf = zx_render_target(line);
+    if (vidBuf)
+    {
+        // -----------------------------------------------------------------------
+        // Render the current line into our NDS video memory. For the ZX 128K, we 
+        // might be using page 7 for video display... it's rare, but possible...
+        // The color attribute is stored independently from the pixel data.
+        // -----------------------------------------------------------------------
+        u8 *zx_ScreenPage = zx_screen_page();
+        u32 *lineBuf = render_line_begin(vidBuf);
+        render_cells(lineBuf, zx_ScreenPage + zx_line_offset(line), &zx_ScreenPage[0x1800 + ((line/8)*32)], 32);
+        render_line_end(vidBuf, lineBuf);
+    }
+
+    if (line == 191) zx_video_frame_done();
+}
+
+// ----------------------------------------------------------------------------
+// Replay one logged screen write. Any screen line it touches which has already
+// been drawn this frame (lines below 'drawn') showed the old value and so must
+// be drawn again next frame.
+// ----------------------------------------------------------------------------
+static inline void zx_beam_apply(BeamWrite_t *w, u32 drawn)
+{
+    zx_beam_screen[w->offset] = w->value;
+    if (w->offset < 0x1800)
+    {
+        u32 line = ((w->offset>>8)&0x07) | ((w->offset>>2)&0x38) | ((w->offset>>5)&0xC0);
+        if (line < drawn) zx_dirty_rows[line] = ZX_DIRTY_ALL;
+    }
+    else
+    {
+        u32 line = ((w->offset-0x1800)>>5)<<3;
+        if (line < drawn) memset(&zx_dirty_rows[line], ZX_DIRTY_ALL, 8);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Render the whole screen in one pass at the end of the frame (see the notes
+// on zx_beam_log[]). Screen line N is fetched by the ULA starting at T-state
+// (N+64) * line length - one character cell every 4 T-states for 128 T-states.
+// ----------------------------------------------------------------------------
+ITCM_CODE void speccy_render_screen_frame(void)
+{
+    u32 line_len = (zx_128k_mode ? 228:224);
+    BeamWrite_t *w = zx_beam_log;
+    BeamWrite_t *end = zx_beam_log + zx_beam_log_len;
+
+    // --------------------------------------------------------------------------
+    // While the tape is playing the T-states don't start over on each new frame
+    // so the log timing means nothing - just show the screen as the frame ended.
+    // --------------------------------------------------------------------------
+    if (zx_beam_resync || tape_state)
+    {
+        memcpy(zx_beam_screen, zx_screen_page(), sizeof(zx_beam_screen));
+        zx_beam_resync = 0;
+        w = end;
+    }
+
+    for (u32 line=0; line<192; line++)
+    {
+        u32 fetch = (line+64) * line_len;
+        while ((w < end) && (w->tstates < fetch)) zx_beam_apply(w++, line);
+
+        u32 *vidBuf = zx_render_target(line);
+        if (vidBuf == NULL) continue;
+
+        u8 *pixelPtr = zx_beam_screen + zx_line_offset(line);
+        u8 *attrPtr  = zx_beam_screen + 0x1800 + ((line/8)*32);
+        u32 *lineBuf = render_line_begin(vidBuf);
+        u32 x = 0;
+
+        // Writes made while the ULA was fetching this line take effect from the cell it had reached
+        while ((w < end) && (w->tstates < fetch + 128))
         {
-            // ------------------------------------------------------------------
-            // Draw background directly to the screen via extended look-up table
-            // ------------------------------------------------------------------
-            *vidBuf++ = zx_colors_extend32[paper];
-            *vidBuf++ = zx_colors_extend32[paper];
+            u32 cell = (w->tstates - fetch) >> 2;
+            if (cell > x)
+            {
+                render_cells(lineBuf + (x*2), pixelPtr + x, attrPtr + x, cell - x);
+                x = cell;
+            }
+            zx_beam_apply(w++, line+1);
         }
+        render_cells(lineBuf + (x*2), pixelPtr + x, attrPtr + x, 32 - x);
+        render_line_end(vidBuf, lineBuf);
     }
+
+    while (w < end) zx_beam_apply(w++, 192); // And the rest of the frame is in the bottom border
+    zx_beam_log_len = 0;
+
+    zx_video_frame_done();
 }
 
 // -----------------------------------------------------
@@ -603,9 +967,24 @@ void speccy_reset(void)
     
     backgroundRenderScreen = 0;
     
-    // Set the 'average' contention delay... 
-    static const u8 contend_delay[3] = {4,3,5};
-    zx_contend_delay = contend_delay[myConfig.contention];
+    // ------------------------------------------------------------------------------
+    // Build the per T-state ULA contention pattern. NORMAL is the real hardware
+    // pattern - LIGHT and HEAVY shave off or add a cycle for games that need it.
+    // ------------------------------------------------------------------------------
+    static const u8 ula_pattern[8] = {6,5,4,3,2,1,0,0};
+    for (int i=0; i<256; i++)
+    {
+        u8 delay = (i < 128) ? ula_pattern[i & 7] : 0;
+        if (delay)
+        {
+            if (myConfig.contention == 1) delay--;          // LIGHT
+            else if (myConfig.contention == 2) delay++;     // HEAVY
+        }
+        zx_ula_contend[i] = delay;
+    }
+#ifdef Z80_PROFILE
+    ResetProfileZ80();  // Each game starts with fresh hot-spot counts
+#endif
     
     // ----------------------------------------------
     // Decompress the Z80/SNA snapshot here...
@@ -804,6 +1183,15 @@ void speccy_reset(void)
         if (zx_128k_mode)   memcpy(RAM_Memory, SpectrumBios128, 0x4000);   // Load ZX 128K BIOS into place
         else                memcpy(RAM_Memory, SpectrumBios, 0x4000);      // Load ZX 48K BIOS into place
     }
+    
+    zx_contend_rebuild();   // Memory contention by slot now that the machine and banking are known
+    zx_contend_set_base();  // And where on the line it starts
+    zx_screen_rebuild();    // Likewise where the screen page is mapped...
+    zx_screen_dirty_all();  // ...and everything needs to be drawn afresh
+
+    zx_beam_render = myConfig.renderMode;   // Rendering line by line or by frame
+    zx_beam_log_len = 0;
+    speccy_frameskip_reset();               // And start out drawing as many frames as we are allowed
 }
 
 
@@ -826,20 +1214,24 @@ ITCM_CODE u32 speccy_run(void)
     if (tape_state)
     {
         // If we are playing back the tape - just run the emulation as fast as possible
-        zx_ScreenRendering = 0;
+        zx_set_rendering(0);
         ExecZ80_Speccy(CPU.TStates + (zx_128k_mode ? 228:224));
     }
     else
     {
         // Grab 2 samples worth of AY sound to mix with the beeper
+        PROFILE_BEGIN(PROF_AUDIO);
         processDirectAudio();
+        PROFILE_END(PROF_AUDIO);
 
         ExecZ80_Speccy(CPU.TStates + (zx_128k_mode ? 132:128)); // Execute CPU for the visible portion of the scanline
         
         // Grab 2 more samples worth of AY sound to mix with the beeper
+        PROFILE_BEGIN(PROF_AUDIO);
         processDirectAudio();
+        PROFILE_END(PROF_AUDIO);
 
-        zx_ScreenRendering = 0; // On this final chunk we are drawing border and doing a horizontal sync... no contention
+        zx_set_rendering(0);    // On this final chunk we are drawing border and doing a horizontal sync... no contention
 
         ExecZ80_Speccy((zx_128k_mode ? 228:224) * zx_current_line); // This puts us exactly where we should be for the scanline
         
@@ -850,6 +1242,7 @@ ITCM_CODE u32 speccy_run(void)
         // -----------------------------------------------------------------------
         if (zx_current_line == (zx_128k_mode ? 311:312))
         {
+            audio_frame_end(CPU.TStates);
             CPU.TStates = 0;
             last_edge = 0;
         }
@@ -862,19 +1255,46 @@ ITCM_CODE u32 speccy_run(void)
     {
         if ((zx_current_line & 0x100) == 0)
         {
-            // Render one scanline... 
-            speccy_render_screen_line(zx_current_line - 64);
-            zx_ScreenRendering = 1;
+            // Render one scanline... unless the whole frame is drawn at the end
+            if (!zx_beam_render)
+            {
+                PROFILE_BEGIN(PROF_RENDER);
+                speccy_render_screen_line(zx_current_line - 64);
+                PROFILE_END(PROF_RENDER);
+            }
+            zx_set_rendering(1);
+            zx_contend_set_base();  // Contention timing for the next line
         }
     }
 
+    zx_border_line[zx_current_line-1] = portFE & 0x07;  // Border colour for this scanline
+
     // ------------------------------------------
     // Generate an interrupt only at end of frame
     // ------------------------------------------
     if (zx_current_line == (zx_128k_mode ? 311:312))
     {
+        zx_border_frame();
         zx_current_line = 0;
-        zx_ScreenRendering = 0;
+        zx_set_rendering(0);
+
+        if (zx_beam_render)
+        {
+            PROFILE_BEGIN(PROF_RENDER);
+            speccy_render_screen_frame();
+            PROFILE_END(PROF_RENDER);
+        }
+
+        // The rendering option can change at any time - but we only switch between frames
+        if (zx_beam_render != myConfig.renderMode)
+        {
+            zx_beam_render = myConfig.renderMode;
+            zx_beam_log_len = 0;
+            zx_screen_dirty_all();
+        }
+
+        zx_idle_last_frame = zx_idle_skipped;
+        zx_idle_skipped = 0;
         CPU.IRequest = INT_RST38;
         CPU.TStates_IRequest = CPU.TStates;
         IntZ80(&CPU, CPU.IRequest);
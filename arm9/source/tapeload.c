@@ -48,16 +48,22 @@
 
 
 #define TAPE_STOP                       0x00
-#define TAPE_START                      0x01
-#define TAPE_NEXT_BLOCK                 0x02
-#define BLOCK_PILOT_TONE                0x03
-#define SYNC_PULSE                      0x04
-#define SEND_DATA_BYTES                 0x05
-#define TAPE_DELAY_AFTER                0x06
-#define CUSTOM_PULSE_SEQ                0x07
+#define TAPE_START                      0x01    // Start playing the current block from the top
+#define TAPE_PLAYING                    0x02    // Walking the runs of the current block
 
-// Yes, this is special. It happens frequently enough we trap on the high bit here...
-#define SEND_DATA_BITS                  0x80
+// ----------------------------------------------------------------------------
+// The kinds of run a block is compiled into (see tape_compile_block) and the
+// flags that go with them.
+// ----------------------------------------------------------------------------
+#define TAPE_RUN_PULSES                 0x00    // 'length' pulses of 'width' - the first at 'level' and the rest alternating
+#define TAPE_RUN_DATA                   0x01    // 'length' bytes of block data - two pulses of the zero or one width per bit
+#define TAPE_RUN_PAUSE                  0x02    // 'length' T-states of silence and then a look for a new loader
+#define TAPE_RUN_END                    0x03    // On to the next block
+
+#define TAPE_RUN_ANCHOR                 0x01    // Timed from the read which reaches the run - not from where the last one ended
+#define TAPE_RUN_STOP                   0x02    // Stop the tape at the end of the pause
+
+#define MAX_TAPE_RUNS                   (255+8) // Enough for the longest pulse sequence block
 
 // ---------------------------------------------------------
 // Some defaults mostly for the .TAP files and
@@ -83,41 +89,55 @@ typedef struct
   u16  sync1_width;             // Length of SYNC first pulse {667}
   u16  sync2_width;             // Length of SYNC second pulse {735}
   u16  data_zero_width;         // How wide the zero '0' bit pulse is {855}
-  u16  data_zero_widthX2;       // How wide the zero '0' bit pulse is {855*2}
   u16  data_one_width;          // How wide the one '1' bit pulse is {1710}
-  u16  data_one_widthX2;        // How wide the one '1' bit pulse is {1710*2}
   u8   last_bits_used;          // The number of bits used in the last byte
   u16  gap_delay_after;         // How many milliseconds delay after this block {1000}
   u16  loop_counter;            // For Loops... how many times to iterate
-  u32  block_data_idx;          // Where does the block data start (after header stuff is parsed)
-  u32  block_data_len;          // How many bytes are in the data stream for this block?
-  char description[31];         // For text / meta / description / group blocks (they can be larger, but this is all we will show)
-  char block_filename[11];      // For the filename in a header block
-  u16  custom_pulse_len[255];   // For the BLOCK_ID_PULSE_SEQ type of block
+  u32  block_data_idx;          // Where does the block data start (after header stuff is parsed) - or the pulse lengths or text of the block
+  u32  block_data_len;          // How many bytes are in the data stream for this block? Or how many characters of text
 } TapeBlock_t;
 
+// ----------------------------------------------------------------------------
+// One run of the compiled block - see tape_compile_block()
+// ----------------------------------------------------------------------------
+typedef struct
+{
+  u8   kind;                    // TAPE_RUN_PULSES, TAPE_RUN_DATA, TAPE_RUN_PAUSE or TAPE_RUN_END
+  u8   flags;                   // TAPE_RUN_ANCHOR and TAPE_RUN_STOP
+  u8   level;                   // Level of the first pulse - 0x00 or 0x40
+  u8   last_bits;               // Bits used in the last byte of data
+  u16  width;                   // T-states of each pulse (of a zero bit for data)
+  u16  width_one;               // T-states of each pulse of a one bit
+  u32  length;                  // Pulses in the run, bytes of data or T-states of pause
+  u32  data_idx;                // Where the data starts in ROM_Memory[]
+} TapeRun_t;
+
 TapeBlock_t TapeBlocks[MAX_TAPE_BLOCKS];  // The .TAP or .TZX will be parsed and this will be filled in.
+TapeRun_t   TapeRuns[MAX_TAPE_RUNS];      // And the block being played is compiled into this
+u16 num_runs_available          __attribute__((section(".dtcm"))) = 0;
 u8  tape_state                  __attribute__((section(".dtcm"))) = TAPE_STOP;
 u16 num_blocks_available        __attribute__((section(".dtcm"))) = 0;
 u16 current_block               __attribute__((section(".dtcm"))) = 0;
 u32 current_block_data_idx      __attribute__((section(".dtcm"))) = 0;
 u32 tape_bytes_processed        __attribute__((section(".dtcm"))) = 0;
-u32 header_pulses               __attribute__((section(".dtcm"))) = 0;
+u32 tape_run_left               __attribute__((section(".dtcm"))) = 0;
 u16 current_bit                 __attribute__((section(".dtcm"))) = 0x100;
 u32 current_bytes_this_block    __attribute__((section(".dtcm"))) = 0;
 u8  handle_last_bits            __attribute__((section(".dtcm"))) = 0;
-u8  custom_pulse_idx            __attribute__((section(".dtcm"))) = 0;
+u16 current_run                 __attribute__((section(".dtcm"))) = 0;
 u16 loop_counter                __attribute__((section(".dtcm"))) = 0;
 u16 loop_block                  __attribute__((section(".dtcm"))) = 0;
 u32 last_edge                   __attribute__((section(".dtcm"))) = 0;
 
-u32 next_edge1                  __attribute__((section(".dtcm"))) = 0;
-u32 next_edge2                  __attribute__((section(".dtcm"))) = 0;
+u32 tape_edge_end               __attribute__((section(".dtcm"))) = 0;  // Where the pulse being played ends
+u32 tape_bit_end                __attribute__((section(".dtcm"))) = 0;  // And where the second pulse of a data bit will end
+u8  tape_level                  __attribute__((section(".dtcm"))) = 0;  // The level of that pulse (0x00 or 0x40)
 
 u8 give_up_counter = 0;
 char *loader_type = "STANDARD";
 u8 tape_sample_standard(void);
 u8 tape_pre_edge_accel(void);
+u8 tape_trap_ld_bytes(void);
 
 inline byte OpZ80(word A)  {return *(MemoryMap[(A)>>14] + ((A)&0x3FFF));}
 
@@ -141,22 +161,44 @@ u8 tape_find_positions(void)
 
     for (u16 i=0; i < num_blocks_available; i++)
     {
-        if ((strlen(TapeBlocks[i].description) > 2) && (strcasestr(TapeBlocks[i].description, "CREATED WITH") == 0))
+        // ------------------------------------------------------------------------------
+        // The descriptions and filenames are not kept with the blocks - we pick them up
+        // from the tape image in ROM_Memory[] where the block points to them.
+        // ------------------------------------------------------------------------------
+        char description[27];
+        char block_filename[11];
+        memset(description, 0x00, sizeof(description));
+        memset(block_filename, 0x00, sizeof(block_filename));
+
+        TapeBlock_t *block = &TapeBlocks[i];
+        if ((block->id == BLOCK_ID_TEXT) || (block->id == BLOCK_ID_GROUP_START))
+        {
+            memcpy(description, &ROM_Memory[block->block_data_idx], block->block_data_len);
+        }
+        else if ((block->id == BLOCK_ID_STANDARD) || (block->id == BLOCK_ID_TURBO))
         {
-            strcpy(TapePositionTable[pos_idx].description, TapeBlocks[i].description);
+            if (!(block->block_flag & 0x80) || (block->block_data_len == 19)) // Header
+            {
+                memcpy(block_filename, &ROM_Memory[block->block_data_idx+2], 10);
+            }
+        }
+
+        if ((strlen(description) > 2) && (strcasestr(description, "CREATED WITH") == 0))
+        {
+            strcpy(TapePositionTable[pos_idx].description, description);
             TapePositionTable[pos_idx].block_id = i;
             if (++pos_idx == 255) break; // That's all we can handle
         }
-        else if (strlen(TapeBlocks[i].block_filename) > 2)
+        else if (strlen(block_filename) > 2)
         {
             u8 bad=0;
             for (u8 j=0; j<10; j++)
             {
-                if (!isprint((int)TapeBlocks[i].block_filename[j])) bad=1;
+                if (!isprint((int)block_filename[j])) bad=1;
             }
             if (!bad)
             {
-                strcpy(TapePositionTable[pos_idx].description, TapeBlocks[i].block_filename);
+                strcpy(TapePositionTable[pos_idx].description, block_filename);
                 TapePositionTable[pos_idx].block_id = i;
                 if (++pos_idx == 255) break; // That's all we can handle
             }
@@ -186,7 +228,7 @@ u8 tape_preloader_delay(void)
 void tape_patch(void)
 {
     // Reset the patch table to all zeros
-    memset(PatchLookup, 0x00, 256*1024);
+    memset(PatchLookup, 0x00, 0x10000 * sizeof(patchFunc));   // 256K on the DS - one function pointer per Z80 address
 
     if (myConfig.tapeSpeed)
     {
@@ -194,6 +236,11 @@ void tape_patch(void)
         PatchLookup[0x05EA] = tape_pre_edge_accel;  // DEC A followed by JRNZ back to the DEC A (delay loop) 0x3D 0x20 +0xFD
         PatchLookup[0x0575] = tape_preloader_delay; // DJNZ jumping back to itself... pre-loader delay loop
         loader_type = "STANDARD";
+
+        if (myConfig.tapeSpeed == 2)
+        {
+            PatchLookup[0x0564] = tape_trap_ld_bytes;   // The first read of the tape in LD-BYTES - standard blocks load in an instant
+        }
     }
 }
 
@@ -242,18 +289,9 @@ void tape_parse_blocks(int tapeSize)
             TapeBlocks[num_blocks_available].data_zero_width = DEFAULT_DATA_ZERO_PULSE_WIDTH;
             TapeBlocks[num_blocks_available].last_bits_used  = DEFAULT_LAST_USED_BITS;
 
-            // Precompute the X2 values of the one/zero pulse width to speed up edge detection
-            TapeBlocks[num_blocks_available].data_one_widthX2  = TapeBlocks[num_blocks_available].data_one_width << 1;
-            TapeBlocks[num_blocks_available].data_zero_widthX2 = TapeBlocks[num_blocks_available].data_zero_width << 1;
-
             TapeBlocks[num_blocks_available].block_data_idx  = idx+2;
             TapeBlocks[num_blocks_available].block_data_len  = block_len;
             TapeBlocks[num_blocks_available].block_flag      = block_flag;
-
-            if (!(block_flag & 0x80) || (block_len == 19)) // Header
-            {
-                memcpy(TapeBlocks[num_blocks_available].block_filename, &ROM_Memory[idx+4], 10);
-            }
             num_blocks_available++;
 
             idx += (block_len + 2); // The two bytes of meta-data length plus the data
@@ -293,14 +331,6 @@ void tape_parse_blocks(int tapeSize)
                     TapeBlocks[num_blocks_available].block_data_idx  = idx+4;
                     TapeBlocks[num_blocks_available].block_data_len  = block_len;
                     TapeBlocks[num_blocks_available].block_flag      = block_flag;
-                    // Precompute the X2 values of the one/zero pulse width to speed up edge detection
-                    TapeBlocks[num_blocks_available].data_one_widthX2  = TapeBlocks[num_blocks_available].data_one_width << 1;
-                    TapeBlocks[num_blocks_available].data_zero_widthX2 = TapeBlocks[num_blocks_available].data_zero_width << 1;
-
-                    if (!(block_flag & 0x80) || (block_len == 19)) // Header
-                    {
-                        memcpy(TapeBlocks[num_blocks_available].block_filename, &ROM_Memory[idx+4+2], 10);
-                    }
 
                     num_blocks_available++;
                     idx += (block_len + 4);
@@ -329,14 +359,6 @@ void tape_parse_blocks(int tapeSize)
                     TapeBlocks[num_blocks_available].block_data_idx  = idx+18;
                     TapeBlocks[num_blocks_available].block_data_len  = block_len;
                     TapeBlocks[num_blocks_available].block_flag      = block_flag;
-                    // Precompute the X2 values of the one/zero pulse width to speed up edge detection
-                    TapeBlocks[num_blocks_available].data_one_widthX2  = TapeBlocks[num_blocks_available].data_one_width << 1;
-                    TapeBlocks[num_blocks_available].data_zero_widthX2 = TapeBlocks[num_blocks_available].data_zero_width << 1;
-
-                    if (!(block_flag & 0x80) || (block_len == 19)) // Header
-                    {
-                        memcpy(TapeBlocks[num_blocks_available].block_filename, &ROM_Memory[idx+18+2], 10);
-                    }
 
                     num_blocks_available++;
                     idx += (block_len + 18);
@@ -353,15 +375,11 @@ void tape_parse_blocks(int tapeSize)
 
                 case BLOCK_ID_PULSE_SEQ:
                     pilot_pulses = ROM_Memory[idx++];
-                    for (u16 i=0; i < pilot_pulses; i++)
-                    {
-                        pilot_length = ROM_Memory[idx+0]  | (ROM_Memory[idx+1]  << 8);
-                        idx += 2;
-                        TapeBlocks[num_blocks_available].custom_pulse_len[i] = pilot_length;
-                    }
                     TapeBlocks[num_blocks_available].pilot_length    = 0;
                     TapeBlocks[num_blocks_available].pilot_pulses    = pilot_pulses;
+                    TapeBlocks[num_blocks_available].block_data_idx  = idx;    // The pulse lengths are read from the tape as the block is compiled
                     num_blocks_available++;
+                    idx += (pilot_pulses * 2);
                     break;
 
                 case BLOCK_ID_PURE_DATA:
@@ -381,9 +399,6 @@ void tape_parse_blocks(int tapeSize)
                     TapeBlocks[num_blocks_available].block_flag      = block_flag;
                     TapeBlocks[num_blocks_available].sync1_width     = 0;   // Must be zero so we skip the sync
                     TapeBlocks[num_blocks_available].sync2_width     = 0;   // Must be zero so we skip the sync
-                    // Precompute the X2 values of the one/zero pulse width to speed up edge detection
-                    TapeBlocks[num_blocks_available].data_one_widthX2  = TapeBlocks[num_blocks_available].data_one_width << 1;
-                    TapeBlocks[num_blocks_available].data_zero_widthX2 = TapeBlocks[num_blocks_available].data_zero_width << 1;
                     num_blocks_available++;
                     idx += (block_len + 10);
                     break;
@@ -402,7 +417,8 @@ void tape_parse_blocks(int tapeSize)
 
                 case BLOCK_ID_GROUP_START: // Group Start
                     block_len = ROM_Memory[idx + 0];
-                    memcpy(TapeBlocks[num_blocks_available].description, &ROM_Memory[idx+1], (block_len < 26 ? block_len:26));
+                    TapeBlocks[num_blocks_available].block_data_idx  = idx+1;
+                    TapeBlocks[num_blocks_available].block_data_len  = (block_len < 26 ? block_len:26);
                     num_blocks_available++;
                     idx += (block_len + 1);
                     break;
@@ -424,7 +440,8 @@ void tape_parse_blocks(int tapeSize)
 
                 case BLOCK_ID_TEXT: // Text Description
                     block_len = ROM_Memory[idx + 0];
-                    memcpy(TapeBlocks[num_blocks_available].description, &ROM_Memory[idx+1], (block_len < 26 ? block_len:26));
+                    TapeBlocks[num_blocks_available].block_data_idx  = idx+1;
+                    TapeBlocks[num_blocks_available].block_data_len  = (block_len < 26 ? block_len:26);
                     num_blocks_available++;
                     idx += (block_len + 1);
                     break;
@@ -483,10 +500,12 @@ void tape_reset(void)
     current_block_data_idx = 0;
     current_block = 0;
     tape_bytes_processed = 0;
-    custom_pulse_idx = 0;
+    current_run = 0;
+    num_runs_available = 0;
     give_up_counter = 0;
     last_edge = 0;
-    next_edge1 = next_edge2 = 0;
+    tape_edge_end = tape_bit_end = 0;
+    tape_level = 0x00;
 }
 
 void tape_stop(void)
@@ -581,314 +600,499 @@ ITCM_CODE u8 tape_pre_edge_accel(void)
     return CPU.AF.B.h;
 }
 
-// ----------------------------------------------------------------
-// This is called when the Spectrum ULA reads from port 0xFE
-// It will sift and sort the current tape block data and return
-// the appropriate bit to the caller who will put it into the port
-// read return byte.
-// ----------------------------------------------------------------
-ITCM_CODE u8 tape_pulse(void)
+// ----------------------------------------------------------------------------------------------
+// Rather than work out the pilot, sync and bit widths from TapeBlocks[] on every read of the
+// port, each block is compiled into a short list of runs just before it plays. Loops, groups,
+// text and 'stop if 48K' blocks are sorted out on the way to the next block and only make it
+// into the list as the choice of which block plays. A run is timed either from the end of the
+// one before it or - the ANCHOR flag - from the read which reaches it which is how the loaders
+// have always seen the tape: every block, the sync pulses, each bit of data, each pulse of a
+// pulse sequence and the pause after a block start when the loader gets to them.
+// ----------------------------------------------------------------------------------------------
+static u8 tape_run_flags = 0;
+
+static void tape_add_run(u8 kind, u8 level, u16 width, u32 length)
 {
-    u32 pilot_pulse = 0;
-#if 0
-    debug[0]  = OpZ80(CPU.PC.W-10);
-    debug[1]  = OpZ80(CPU.PC.W-9);
-    debug[2]  = OpZ80(CPU.PC.W-8);
-    debug[3]  = OpZ80(CPU.PC.W-7);
-    debug[4]  = OpZ80(CPU.PC.W-6);
-    debug[5]  = OpZ80(CPU.PC.W-5);
-    debug[6]  = OpZ80(CPU.PC.W-4);
-    debug[7]  = OpZ80(CPU.PC.W-3);
-    debug[8]  = OpZ80(CPU.PC.W-2);
-    debug[9]  = OpZ80(CPU.PC.W-1);
-    debug[10] = OpZ80(CPU.PC.W+0);
-    debug[11] = OpZ80(CPU.PC.W+1);
-    debug[12] = OpZ80(CPU.PC.W+2);
-    debug[13] = OpZ80(CPU.PC.W+3);
-    debug[14] = OpZ80(CPU.PC.W+4);
-    debug[15] = OpZ80(CPU.PC.W+5);
-#endif
-
-    // Don't return from the state machine until we have a bit value to return
-    while (1)
-    {
-        switch (tape_state)
-        {
-            case TAPE_STOP:
-                return 0x00;
-                break;
+    TapeRun_t *run = &TapeRuns[num_runs_available++];
+    run->kind   = kind;
+    run->flags  = tape_run_flags;
+    run->level  = level;
+    run->width  = width;
+    run->length = length;
+    tape_run_flags = 0;
+}
 
-            case TAPE_START:
-                last_edge = 0;
-                next_edge1 = next_edge2 = 0;
-                tape_state = TAPE_NEXT_BLOCK;
-                break;
+static void tape_add_pulses(u8 level, u16 width, u32 count)
+{
+    if (width && count) tape_add_run(TAPE_RUN_PULSES, level, width, count);  // Nothing to play - the anchor moves on to the next run
+}
 
-            case TAPE_NEXT_BLOCK:
-                // -------------------------------------------------------------
-                // If we've exhausted all of the tape blocks, we stop the
-                // tape and set the current block back to the start of the tape.
-                // -------------------------------------------------------------
-                if (current_block >= num_blocks_available)
-                {
-                    tape_state = TAPE_STOP; // Stop the playback
-                    current_block = 0;      // Wrap back around
-                    break;                  // And move directly to the STOP state
-                }
+static void tape_compile_block(TapeBlock_t *block)
+{
+    num_runs_available = 0;
+    tape_run_flags = TAPE_RUN_ANCHOR;
 
-                // ----------------------------------------------------------------
-                // When we start a new block, we start the CPU timer at the top
-                // And we set the block data index back to the start of the block.
-                // ----------------------------------------------------------------
-                last_edge = CPU.TStates;
-                give_up_counter = 0;
-                current_block_data_idx = TapeBlocks[current_block].block_data_idx;
-
-                // ------------------------------------------------
-                // Now... let's see what magic this block holds...
-                // ------------------------------------------------
-                switch (TapeBlocks[current_block].id)
-                {
-                    case BLOCK_ID_STANDARD:  // Standard Play Block
-                    case BLOCK_ID_TURBO:     // Turbo Load Block
-                    case BLOCK_ID_PURE_TONE: // Pilot Tone Only Block
-                        tape_state = BLOCK_PILOT_TONE;
-                        break;
-
-                    case BLOCK_ID_PULSE_SEQ:      // Custom pulse sequence
-                        custom_pulse_idx = 0;
-                        tape_state = CUSTOM_PULSE_SEQ;
-                        break;
-
-                    case BLOCK_ID_PURE_DATA:      // Pure Data Block
-                        tape_state = SYNC_PULSE;  // We've set the sync1/sync2 both to zero so this will immediately go into data send
-                        break;
-
-                    case BLOCK_ID_PAUSE_STOP:     // Delay/Pause/Stop the Tape
-                        last_edge = CPU.TStates;
-                        tape_state = TAPE_DELAY_AFTER;
-                        break;
-
-                    case BLOCK_ID_STOP_IF_48K: // Stop if 48K
-                        if (!zx_128k_mode) // If we are 48K Spectrum
-                        {
-                            tape_state = TAPE_STOP;
-                        }
-                        else // For 128K we can move to the next block
-                        {
-                            current_block++;
-                            tape_state = TAPE_NEXT_BLOCK;
-                        }
-                        break;
+    switch (block->id)
+    {
+        case BLOCK_ID_STANDARD:
+        case BLOCK_ID_TURBO:
+        case BLOCK_ID_PURE_TONE:
+            // Always end the pilot tone on a high pulse to keep the SYNC pulses the right way up
+            tape_add_pulses(0x00, block->pilot_length, (block->pilot_pulses + 1) & ~1);
+            if (block->id == BLOCK_ID_PURE_TONE) break;
+
+            tape_run_flags = TAPE_RUN_ANCHOR;
+            tape_add_pulses(0x00, block->sync1_width, 1);
+            tape_add_pulses(0x40, block->sync2_width, 1);
+            // Fall through to send the data...
+
+        case BLOCK_ID_PURE_DATA:    // No pilot or sync
+            tape_run_flags = TAPE_RUN_ANCHOR;
+            tape_add_run(TAPE_RUN_DATA, 0x00, block->data_zero_width, block->block_data_len);
+            TapeRuns[num_runs_available-1].width_one = block->data_one_width;
+            TapeRuns[num_runs_available-1].last_bits = block->last_bits_used;
+            TapeRuns[num_runs_available-1].data_idx  = block->block_data_idx;
+
+            tape_run_flags = TAPE_RUN_ANCHOR;
+            tape_add_run(TAPE_RUN_PAUSE, 0x00, 0, block->gap_delay_after * 3500);
+            break;
+
+        case BLOCK_ID_PULSE_SEQ:
+            for (u16 i=0; i < block->pilot_pulses; i++)
+            {
+                u32 idx = block->block_data_idx + (i * 2);
+                tape_run_flags = TAPE_RUN_ANCHOR;
+                tape_add_pulses((i & 1) ? 0x40:0x00, ROM_Memory[idx] | (ROM_Memory[idx+1] << 8), 1);
+            }
+            break;
+
+        case BLOCK_ID_PAUSE_STOP:   // A delay of zero is a stop
+            tape_run_flags = TAPE_RUN_ANCHOR | (block->gap_delay_after ? 0 : TAPE_RUN_STOP);
+            tape_add_run(TAPE_RUN_PAUSE, 0x00, 0, block->gap_delay_after * 3500);
+            break;
+    }
 
-                    case BLOCK_ID_LOOP_START:
-                        loop_counter = TapeBlocks[current_block].loop_counter;
-                        current_block++;
-                        loop_block = current_block;
-                        tape_state = TAPE_NEXT_BLOCK;
-                        break;
+    tape_add_run(TAPE_RUN_END, 0x00, 0, 0);
+}
 
-                    case BLOCK_ID_LOOP_END:
-                        if (loop_counter) // If not done with loop, go back to the block after the loop started
-                        {
-                            loop_counter--;
-                            current_block = loop_block;
-                        }
-                        else // Done with loop... move along
-                        {
-                            current_block++;
-                        }
-                        tape_state = TAPE_NEXT_BLOCK;
-                        break;
+// Start the current run - the previous pulse ended at tape_edge_end
+static void tape_run_begin(void)
+{
+    TapeRun_t *run = &TapeRuns[current_run];
+    u32 from = (run->flags & TAPE_RUN_ANCHOR) ? CPU.TStates : tape_edge_end;
 
-                    case BLOCK_ID_GROUP_START:
-                    case BLOCK_ID_TEXT:
-                        current_block++;
-                        break;
+    switch (run->kind)
+    {
+        case TAPE_RUN_PULSES:
+            tape_level = run->level;
+            tape_run_left = run->length;
+            tape_edge_end = from + run->width;
+            break;
+
+        case TAPE_RUN_DATA:
+            last_edge = from;
+            current_block_data_idx = run->data_idx;
+            current_bytes_this_block = 0;
+            current_bit = 0x100;    // So when we shift it down we'll be looking at the high (7th) bit of data
+            handle_last_bits = (run->length == 1) ? (0x80 >> run->last_bits) : 0x00;
+            tape_level = 0x40;      // As if a bit just ended - the first one starts right away
+            tape_edge_end = from;
+            break;
+
+        case TAPE_RUN_PAUSE:
+            tape_level = 0x00;
+            tape_edge_end = from + run->length;
+            break;
+
+        case TAPE_RUN_END:
+            current_block++;
+            tape_state = TAPE_START;
+            break;
+    }
+}
 
-                    default: //TODO: add more block IDs for TZX and trap ones we don't handle...
-                        tape_state = TAPE_STOP;
-                        break;
-                }
-                break;
+// ----------------------------------------------------------------------------------------------
+// Find the next block to play - skipping (or acting on) the ones which have nothing to play -
+// and compile it. Runs out of tape and we stop and rewind back to the start of the tape.
+// ----------------------------------------------------------------------------------------------
+static void tape_next_block(void)
+{
+    while (1)
+    {
+        if (current_block >= num_blocks_available)
+        {
+            tape_state = TAPE_STOP; // Stop the playback
+            current_block = 0;      // Wrap back around
+            return;
+        }
 
-            case BLOCK_PILOT_TONE:
-                pilot_pulse = ((CPU.TStates-last_edge) / TapeBlocks[current_block].pilot_length); // How many pulses are we into this thing...
+        last_edge = CPU.TStates;
+        give_up_counter = 0;
 
-                // Always end the pilot tone on a high bit sent to simplify the logic on the SYNC pulse below
-                if ((pilot_pulse < TapeBlocks[current_block].pilot_pulses) || (pilot_pulse & 1)) // Are we still in the pilot tone send?
-                {
-                    if (pilot_pulse & 1) return 0x40; else return 0x00;  // Send the pulse bit
-                }
-                else  // We're done with the pilot tone... get ready to send the SYNC PULSE
+        TapeBlock_t *block = &TapeBlocks[current_block];
+        switch (block->id)
+        {
+            case BLOCK_ID_STANDARD:
+            case BLOCK_ID_TURBO:
+            case BLOCK_ID_PURE_TONE:
+            case BLOCK_ID_PULSE_SEQ:
+            case BLOCK_ID_PURE_DATA:
+            case BLOCK_ID_PAUSE_STOP:
+                tape_compile_block(block);
+                current_run = 0;
+                tape_state = TAPE_PLAYING;
+                tape_run_begin();
+                return;
+
+            case BLOCK_ID_STOP_IF_48K:
+                if (!zx_128k_mode)  // The 128K carries on to the next block
                 {
-                    last_edge = CPU.TStates;
-                    if (TapeBlocks[current_block].id == BLOCK_ID_PURE_TONE) // If pure tone... we're done.
-                    {
-                        current_block++;
-                        tape_state = TAPE_NEXT_BLOCK;
-                    }
-                    else // Otherwise move on to the Sync Pulse
-                    {
-                        tape_state = SYNC_PULSE;
-                    }
+                    tape_state = TAPE_STOP;
+                    return;
                 }
+                current_block++;
+                break;
+
+            case BLOCK_ID_LOOP_START:
+                loop_counter = block->loop_counter;
+                current_block++;
+                loop_block = current_block;
                 break;
 
-            case CUSTOM_PULSE_SEQ:
-                if ((CPU.TStates-last_edge) < TapeBlocks[current_block].custom_pulse_len[custom_pulse_idx])
+            case BLOCK_ID_LOOP_END:
+                if (loop_counter) // If not done with loop, go back to the block after the loop started
                 {
-                    if (custom_pulse_idx & 1) return 0x40; else return 0x00;  // Send the pulse bit
+                    loop_counter--;
+                    current_block = loop_block;
                 }
-                else  // Check if we're done with the custom pulse sequence...
+                else // Done with loop... move along
                 {
-                    last_edge = CPU.TStates;
-                    if (++custom_pulse_idx >= TapeBlocks[current_block].pilot_pulses)
-                    {
-                        current_block++;
-                        tape_state = TAPE_NEXT_BLOCK;
-                    }
+                    current_block++;
                 }
                 break;
 
-            case SYNC_PULSE:
-                if ((CPU.TStates-last_edge) < TapeBlocks[current_block].sync1_width) return 0x00;
-                else if ((CPU.TStates-last_edge) < (TapeBlocks[current_block].sync1_width + TapeBlocks[current_block].sync2_width)) return 0x40;
-                else
-                {
-                    last_edge = CPU.TStates;
-                    current_bit = 0x100;    // So when we shift it down we'll be looking at the high (7th) bit of data
-                    current_bytes_this_block = 0;
-                    tape_state = SEND_DATA_BYTES;
-                    if (TapeBlocks[current_block].block_data_len == 1)
-                    {
-                        handle_last_bits = 0x80 >> TapeBlocks[current_block].last_bits_used;
-                    }
-                    else
-                    {
-                        handle_last_bits = 0x00;
-                    }
-                }
+            case BLOCK_ID_GROUP_START:
+            case BLOCK_ID_TEXT:
+                current_block++;
                 break;
 
-            case SEND_DATA_BYTES:
-                current_bit = current_bit>>1;
+            default: //TODO: add more block IDs for TZX and trap ones we don't handle...
+                tape_state = TAPE_STOP;
+                return;
+        }
+    }
+}
 
-                // --------------------------------------------------------------------------
-                // If slow bit reads are happening (arbitrarily above 10000 CPU ticks), we
-                // increment a "give up" counter... if this reaches critical mass, we simply
-                // stop the tape as it no longer looks like we are trying to load anything.
-                // --------------------------------------------------------------------------
-                if ((CPU.TStates-last_edge) > 10000) // Slow bit reads happening?
-                {
-                    if (++give_up_counter > 5)
-                    {
-                        if (myConfig.autoStop)
-                        {
-                            tape_stop();
-                            return 0x00;
-                        }
-                        else // No auto-stop... best we can do is go back to the start of the block
-                        {
-                            tape_stop();
-                            tape_play();
-                            return 0x00;
-                        }
-                    }
-                }
+// ----------------------------------------------------------------------------------------------
+// The second pulse of a data bit is done - start the next bit. Returns 0 when the data is all
+// sent. If slow bit reads are happening (arbitrarily above 10000 CPU ticks), we increment a
+// "give up" counter... if this reaches critical mass, we simply stop the tape as it no longer
+// looks like we are trying to load anything.
+// ----------------------------------------------------------------------------------------------
+static u8 tape_data_bit(TapeRun_t *run)
+{
+    while (1)
+    {
+        current_bit = current_bit >> 1;
 
-                if (current_bit == handle_last_bits) // Are we done sending this byte?
-                {
-                    tape_bytes_processed++;
-                    current_block_data_idx++;
-                    if (++current_bytes_this_block >= TapeBlocks[current_block].block_data_len)
-                    {
-                        last_edge = CPU.TStates;
-                        tape_state = TAPE_DELAY_AFTER; // We're done with this block... delay after
-                        // Do not return here... if delay is zero we don't want to perform any transition
-                    }
-                    else  // We've got another byte to process...
-                    {
-                        current_bit = 0x100;
-
-                        // Check if we are on the very last byte... some Turbo Loaders don't send all the bits
-                        if ((current_bytes_this_block+1) >= TapeBlocks[current_block].block_data_len)
-                        {
-                             // ----------------------------------------------------------------------------------
-                             // If this loader does not pulse out all the final bits, we need to set up a
-                             // mask other than 0x00 so that we know when to terminate the last byte transmission.
-                             // ----------------------------------------------------------------------------------
-                             handle_last_bits = 0x80 >> TapeBlocks[current_block].last_bits_used;
-                        }
-                        tape_state = SEND_DATA_BYTES;
-                    }
-                }
-                else
-                {
-                    // We need to send one bit of data...
-                    last_edge = CPU.TStates;
-                    tape_state = SEND_DATA_BITS;
-                    if (ROM_Memory[current_block_data_idx] & current_bit)
-                    {
-                        next_edge1 = last_edge + TapeBlocks[current_block].data_one_width;
-                        next_edge2 = last_edge + TapeBlocks[current_block].data_one_widthX2;
-                    }
-                    else
-                    {
-                        next_edge1 = last_edge + TapeBlocks[current_block].data_zero_width;
-                        next_edge2 = last_edge + TapeBlocks[current_block].data_zero_widthX2;
-                    }
-                }
-                break;
+        if ((CPU.TStates-last_edge) > 10000) // Slow bit reads happening?
+        {
+            if (++give_up_counter > 5)
+            {
+                tape_stop();
+                if (!myConfig.autoStop) tape_play();   // No auto-stop... best we can do is go back to the start of the block
+                return 0;
+            }
+        }
 
-            case SEND_DATA_BITS:
-                if      (CPU.TStates <= next_edge1) return 0x00;
-                else if (CPU.TStates <= next_edge2) return 0x40;
-                else
-                {
-                    tape_state = SEND_DATA_BYTES;
-                }
-                break;
+        if (current_bit != handle_last_bits) break;
 
-            case TAPE_DELAY_AFTER: // Normally ~1 second but can be different for custom tapes
-                if ((CPU.TStates-last_edge) < (TapeBlocks[current_block].gap_delay_after * 3500)) return 0x00; // Must be < so we do nothing if delay is zero
-                else
-                {
-                    tape_search_for_loader();
-
-                    // A delay of zero is not special unless we are the BLOCK_ID_PAUSE_STOP block type...
-                    if ((TapeBlocks[current_block].id == BLOCK_ID_PAUSE_STOP) && (TapeBlocks[current_block].gap_delay_after == 0))
-                    {
-                        current_block++;
-                        tape_state = TAPE_STOP;     // To Pause/Stop the tape
-                    }
-                    else
-                    {
-                        current_block++;
-                        tape_state = TAPE_NEXT_BLOCK;    // And off to the next block
-                    }
-                }
-                break;
+        // Done sending this byte...
+        tape_bytes_processed++;
+        current_block_data_idx++;
+        if (++current_bytes_this_block >= run->length) return 0;
+
+        current_bit = 0x100;
+
+        // Check if we are on the very last byte... some Turbo Loaders don't send all the bits
+        if ((current_bytes_this_block+1) >= run->length)
+        {
+            handle_last_bits = 0x80 >> run->last_bits;
         }
     }
+
+    // ----------------------------------------------------------------------------------
+    // Both pulses of a bit run one T-state past their width - the accelerated loaders
+    // below have always been tuned to that so we leave it be.
+    // ----------------------------------------------------------------------------------
+    u16 width = (ROM_Memory[current_block_data_idx] & current_bit) ? run->width_one : run->width;
+    last_edge = CPU.TStates;
+    tape_level = 0x00;
+    tape_edge_end = last_edge + width + 1;
+    tape_bit_end  = tape_edge_end + width;
+    return 1;
+}
+
+// ----------------------------------------------------------------------------------------------
+// The pulse we were playing is over - walk on through the runs until we reach one that isn't.
+// ----------------------------------------------------------------------------------------------
+ITCM_CODE u8 tape_next_edge(void)
+{
+    while (1)
+    {
+        if (tape_state != TAPE_PLAYING)
+        {
+            if (tape_state == TAPE_STOP) return 0x00;
+            tape_next_block();
+            continue;
+        }
+
+        if ((s32)(CPU.TStates - tape_edge_end) < 0) return tape_level;
+
+        TapeRun_t *run = &TapeRuns[current_run];
+        if (run->kind == TAPE_RUN_PULSES)
+        {
+            if (--tape_run_left)    // Another pulse at the other level
+            {
+                tape_level ^= 0x40;
+                tape_edge_end += run->width;
+                continue;
+            }
+        }
+        else if (run->kind == TAPE_RUN_DATA)
+        {
+            if (tape_level == 0x00) // On to the second pulse of the bit
+            {
+                tape_level = 0x40;
+                tape_edge_end = tape_bit_end;
+                continue;
+            }
+            if (tape_data_bit(run)) continue;
+            if (tape_state != TAPE_PLAYING) return 0x00;  // We gave up
+        }
+        else // TAPE_RUN_PAUSE
+        {
+            tape_search_for_loader();
+            if (run->flags & TAPE_RUN_STOP)
+            {
+                current_block++;
+                tape_state = TAPE_STOP;     // To Pause/Stop the tape
+                continue;
+            }
+        }
+
+        current_run++;
+        tape_run_begin();
+    }
+}
+
+// ----------------------------------------------------------------
+// This is called when the Spectrum ULA reads from port 0xFE and
+// returns the level of the tape. Nearly every time the current
+// pulse is still going and that's all we need to know.
+// ----------------------------------------------------------------
+static inline __attribute__((always_inline)) u8 tape_pulse_fast(void)
+{
+    if ((s32)(CPU.TStates - tape_edge_end) < 0) return tape_level;
+    return tape_next_edge();
+}
+
+ITCM_CODE u8 tape_pulse(void)
+{
+    return tape_pulse_fast();
+}
+
+// ----------------------------------------------------------------
+// After a state is loaded - the current block is compiled again
+// so the saved place in its runs means something.
+// ----------------------------------------------------------------
+void tape_rebuild(void)
+{
+    if (tape_state == TAPE_PLAYING) tape_compile_block(&TapeBlocks[current_block]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------
+// The INSTANT tape speed. We trap on the first read of the tape in the ROM LD-BYTES routine (the same code sits
+// in the 48K ROM and in ROM 1 of the 128K) and if the block coming up has standard timing, the whole thing is
+// copied (or verified) straight from the tape image into memory. We then return to the caller exactly where the
+// ROM would once the parity byte was in. Turbo and custom blocks are left for the ROM to find the edges of.
+//
+// 0556 {1} LD-BYTES INC  D          Reset the zero flag (D is not yet being used)
+// 0557 {1}          EX   AF,AF'     Preserve the entry flags - A' is the flag byte wanted and carry set for LOAD
+// 0558 {1}          DEC  D          Restore D
+// 0559 {1}          DI
+// 055A {2}          LD   A,+0F      Make the border white
+// 055C {2}          OUT  (+FE),A
+// 055E {3}          LD   HL,+053F   Pre-load the SA/LD-RET address for the return
+// 0561 {1}          PUSH HL
+// 0562 {2}          IN   A,(+FE)    <== This is where the PC Trap is (PC=0x0564)
+// ---------------------------------------------------------------------------------------------------------------
+static const u8 ld_bytes_rom[] = {0x14, 0x08, 0x15, 0xF3, 0x3E, 0x0F, 0xD3, 0xFE, 0x21, 0x3F, 0x05, 0xE5, 0xDB, 0xFE};
+
+// ----------------------------------------------------------------------------------------------
+// Find the block LD-BYTES is about to load. If we are still in a gap (after the last block, or
+// the silence every tape starts with) the loader doesn't care for the rest of it so we move on.
+// Anything but a block with standard timing (and enough pilot for LD-LEADER to lock on to) or a
+// block already under way and we return NULL and let the ROM work through the edges as usual.
+// ----------------------------------------------------------------------------------------------
+static TapeBlock_t *tape_instant_block(void)
+{
+    while (1)
+    {
+        if ((tape_state == TAPE_PLAYING) && (TapeRuns[current_run].kind == TAPE_RUN_PAUSE))
+        {
+            current_block++;
+            tape_state = TAPE_START;
+        }
+
+        if (tape_state != TAPE_START) break;
+        tape_next_block();
+    }
+
+    if ((tape_state != TAPE_PLAYING) || (current_run != 0)) return NULL;
+
+    TapeBlock_t *block = &TapeBlocks[current_block];
+
+    if ((block->id != BLOCK_ID_STANDARD) && (block->id != BLOCK_ID_TURBO)) return NULL;
+    if (block->pilot_length    != DEFAULT_PILOT_LENGTH)          return NULL;
+    if (block->pilot_pulses    <  512)                           return NULL;
+    if (block->sync1_width     != DEFAULT_SYNC_PULSE1_WIDTH)     return NULL;
+    if (block->sync2_width     != DEFAULT_SYNC_PULSE2_WIDTH)     return NULL;
+    if (block->data_zero_width != DEFAULT_DATA_ZERO_PULSE_WIDTH) return NULL;
+    if (block->data_one_width  != DEFAULT_DATA_ONE_PULSE_WIDTH)  return NULL;
+    if (block->last_bits_used  != DEFAULT_LAST_USED_BITS)        return NULL;
+    if (block->block_data_len  == 0)                             return NULL;
+
+    return block;
 }
 
+// The S, Z and P/V flags as the Z80 core builds them (PZSTable) for the result of a XOR
+static u8 tape_flags_pzs(u8 r)
+{
+    u8 p = r ^ (r >> 4);
+    p ^= p >> 2;
+    p ^= p >> 1;
+    return (r & S_FLAG) | (r ? 0x00 : Z_FLAG) | ((p & 1) ? 0x00 : P_FLAG);
+}
 
-// ----------------------------------------------------------------------------------------
-// Used in our edge-detection accelerated loaders below. This routine will invert and shift
-// down the bits so as to provide a very fast interface to edge detection when clocking in
-// data Zeros or Ones which is quite common when loading tapes.
-// ----------------------------------------------------------------------------------------
-u8 inline __attribute__((always_inline)) tape_pulse_fast(void)
+u8 tape_trap_ld_bytes(void)
 {
-    if      (CPU.TStates <= next_edge1) return ~0x00; // Inverted and shifted down
-    else if (CPU.TStates <= next_edge2) return ~0x20; // So loader does less work
+    // Make sure it's really LD-BYTES paged in and not the other 128K ROM
+    for (u8 i=0; i < sizeof(ld_bytes_rom); i++)
+    {
+        if (OpZ80(0x0556+i) != ld_bytes_rom[i]) return ~tape_pulse();
+    }
+
+    u8 ear = ~tape_pulse();                     // What the IN A,(+FE) reads
+    TapeBlock_t *block = tape_instant_block();
+    if (block == NULL) return ear;
+
+    const u8 *data = &ROM_Memory[block->block_data_idx];
+    u32 len    = block->block_data_len;
+    u32 idx    = 1;
+    u8  load   = CPU.AF1.B.l & C_FLAG;
+    u16 ix     = CPU.IX.W;
+    u16 de     = CPU.DE.W;
+    u8  parity = data[0];
+    u8  last   = data[0];
+
+    // --------------------------------------------------------------------------------------
+    // The registers are left just as the ROM leaves them on each way out - callers get back
+    // AF untouched through SA/LD-RET. LD-EDGE flips all of C on every edge so bit 5 follows
+    // the EAR, and the EAR is at the same level at the end of every byte. So C only depends
+    // on the level the IN above read (and the XOR 03 at the sync). AF' holds the flag byte's
+    // F (zero and parity set, carry for LOAD) with C, or the 0 from LD-VERIFY, while the
+    // bytes are read and the LD A,D / OR E test when we leave part way.
+    // --------------------------------------------------------------------------------------
+    u8 a, f;
+    u8 c  = (ear & 0x40) ? 0x21 : 0xFE;
+    u8 b  = 0xB0;
+    u8 a1 = c;
+    u8 f1 = Z_FLAG | P_FLAG | load;
+
+    if (data[0] != CPU.AF1.B.h)                 // LD-FLAG: RL C, XOR L, RET NZ - not the flag byte we were asked for
+    {
+        c  = (c << 1) | load;
+        a  = data[0] ^ CPU.AF1.B.h;
+        f  = tape_flags_pzs(a);
+        a1 = (de >> 8) | (de & 0xFF);
+        f1 = tape_flags_pzs(a1);
+    }
     else
     {
-         // Experimentally, this happens about 16x less frequently than the bit returns above (makes sense as there are 2x edges per bit in the byte)
-         tape_state = SEND_DATA_BYTES;
-         return ~tape_pulse() >> 1; // Invert and shift down
+        while (1)
+        {
+            if (idx >= len)                     // The tape runs out and LD-EDGE times out on INC B, RET Z
+            {
+                a = 0x00;
+                f = Z_FLAG | H_FLAG;
+                b = 0x00;
+                last = 0x01;                    // LD-MARKER had L ready for the next byte
+                break;
+            }
+
+            last = data[idx++];
+            parity ^= last;
+            if (de == 0)                        // That was the parity byte: LD A,H and CP +01
+            {
+                u8 r = parity - 1;
+                a = parity;
+                f = N_FLAG | (r & S_FLAG) | (r ? 0x00 : Z_FLAG) | ((parity & 0x0F) ? 0x00 : H_FLAG) |
+                    ((parity == 0x80) ? V_FLAG : 0x00) | ((parity == 0x00) ? C_FLAG : 0x00);
+                break;
+            }
+
+            u8 *p = MemoryMap[ix >> 14] + (ix & 0x3FFF);
+            if (!load)                          // LD-VERIFY: LD A,(IX+0), XOR L, RET NZ
+            {
+                if (*p != last)
+                {
+                    a  = *p ^ last;
+                    f  = tape_flags_pzs(a);
+                    a1 = (de >> 8) | (de & 0xFF);
+                    f1 = tape_flags_pzs(a1);
+                    break;
+                }
+                a1 = 0x00;
+            }
+            else if (ix & 0xC000) *p = last;    // LD (IX+0),L - but never into the ROM
+
+            ix++;
+            de--;
+        }
     }
+
+    CPU.AF.B.h  = a;
+    CPU.AF.B.l  = f;
+    CPU.AF1.B.h = a1;
+    CPU.AF1.B.l = f1;
+    CPU.IX.W    = ix;
+    CPU.DE.W    = de;
+    CPU.HL.B.h  = parity;
+    CPU.HL.B.l  = last;
+    CPU.BC.B.h  = b;
+    CPU.BC.B.l  = c;
+
+    tape_bytes_processed += len;
+    zx_screen_dirty_all();                      // Loading screens go straight in too
+
+    // -------------------------------------------------------------------------
+    // The block is done - on to the gap after it. A gap of nothing (as after the
+    // last block) is over already and tape_next_edge() walks on past it, which
+    // stops the tape when that's the end. Either way the search for a loader
+    // this block may have brought in is done once, just as at the end of a block
+    // played out.
+    // -------------------------------------------------------------------------
+    current_run = num_runs_available - 2;
+    tape_run_begin();
+    tape_next_edge();
+    if ((tape_state == TAPE_PLAYING) && (TapeRuns[current_run].kind == TAPE_RUN_PAUSE)) tape_search_for_loader();
+
+    // And return through the SA/LD-RET address which LD-BYTES pushed
+    CPU.PC.B.l = OpZ80(CPU.SP.W); CPU.SP.W++;
+    CPU.PC.B.h = OpZ80(CPU.SP.W); CPU.SP.W++;
+
+    return CPU.AF.B.h;
 }
 
 
@@ -919,15 +1123,7 @@ ITCM_CODE u8 tape_sample_standard(void)
     int B = 255-CPU.BC.B.h;     // Very slight speedups to take these into local stack vars
     const u8 C = CPU.BC.B.l;    // Very slight speedups to take these into local stack vars
 ld_sample:
-    u8 A;
-    if (tape_state & 0x80)      // One or Zero... do it FAST!
-    {
-        A = (tape_pulse_fast()) ^ C;    // This version is already shifted down and inverted...
-    }
-    else
-    {
-        A = (~tape_pulse() >> 1) ^ C;   // Normal version must be inverted and shifted down...
-    }
+    u8 A = (~tape_pulse_fast() >> 1) ^ C;   // Inverted and shifted down as the RRA would
 
     if (A & 0x20)                       // Edge detected. We can exit the loop.
     {
@@ -983,16 +1179,7 @@ ITCM_CODE u8 tape_sample_speedlock(void)
     int B = 255-CPU.BC.B.h;
     const u8 C = CPU.BC.B.l;
 ld_sample:
-    u8 A;
-    if (tape_state & 0x80) // One or Zero... do it FAST!
-    {
-        // This version is already shifted down and inverted...
-        A = (tape_pulse_fast()) ^ C;
-    }
-    else
-    {
-        A = (~tape_pulse() >> 1) ^ C;
-    }
+    u8 A = (~tape_pulse_fast() >> 1) ^ C;
 
     if (A & 0x20)                       // Edge detected. We can exit the loop.
     {
@@ -1050,16 +1237,7 @@ ITCM_CODE u8 tape_sample_alkatraz(void)
     int B = 255-CPU.BC.B.h;
     const u8 C = CPU.BC.B.l;
 ld_sample:
-    u8 A;
-    if (tape_state & 0x80) // One or Zero... do it FAST!
-    {
-        // This version is already shifted down and inverted...
-        A = (tape_pulse_fast()) ^ C;
-    }
-    else
-    {
-        A = (~tape_pulse() >> 1) ^ C;
-    }
+    u8 A = (~tape_pulse_fast() >> 1) ^ C;
 
     if (A & 0x20)                       // Edge detected. We can exit the loop.
     {
@@ -1126,16 +1304,7 @@ ITCM_CODE u8 tape_sample_microsphere_bleepload(void)
     int B = 255-CPU.BC.B.h;
     const u8 C = CPU.BC.B.l;
 ld_sample:
-    u8 A;
-    if (tape_state & 0x80) // One or Zero... do it FAST!
-    {
-        // This version is already shifted down and inverted...
-        A = (tape_pulse_fast()) ^ C;
-    }
-    else
-    {
-        A = (~tape_pulse() >> 1) ^ C;
-    }
+    u8 A = (~tape_pulse_fast() >> 1) ^ C;
 
     if (A & 0x20)                       // Edge detected. We can exit the loop.
     {
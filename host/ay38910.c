@@ -0,0 +1,159 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+//
+// A portable C stand-in for FluBBa's ARM assembly AY-3-8910 core so the host
+// build links. Same API and same rough output level/clocking as the DS build
+// (AY_UPSHIFT=2 - four chip ticks per output sample) but it is not meant to be
+// bit exact - it only has to cost roughly the same and sound roughly the same.
+//
+#include <nds.h>
+#include <string.h>
+#include "cpu/ay38910/AY38910.h"
+
+#ifndef AY_UPSHIFT
+#define AY_UPSHIFT 2
+#endif
+
+// Logarithmic DAC levels of the real chip scaled to a per-channel maximum of 0x800
+static const s16 ay_levels[16] = {0x000, 0x016, 0x01F, 0x02D, 0x044, 0x060, 0x082, 0x0CE,
+                                  0x0F3, 0x15E, 0x1F8, 0x266, 0x335, 0x478, 0x5E7, 0x800};
+
+// We re-use the fields of the assembly struct for our own counters:
+//   chXFreq = half-period countdown, chXAddr = current output (0/1)
+//   ch3 = noise, ayEnvFreq = envelope countdown, ayEnvAddr = envelope step (0-31)
+static u16 *ay_freq(AY38910 *chip, int ch) {return &chip->ch0Freq + ch*2;}
+static u16 *ay_out(AY38910 *chip, int ch)  {return &chip->ch0Addr + ch*2;}
+
+static u8 ay_env_volume(AY38910 *chip)
+{
+    u8 shape = chip->ayRegs[13] & 0x0F;
+    u8 step  = chip->ayEnvAddr;
+
+    if (step < 16)  // First ramp is always up (attack) or down
+    {
+        return (shape & 0x04) ? step : (15 - step);
+    }
+
+    if (!(shape & 0x08)) return 0;                 // Shapes 0-7 hold at zero after one cycle
+    if (shape & 0x01)                              // Hold
+    {
+        u8 last = (shape & 0x04) ? 15 : 0;
+        return (shape & 0x02) ? (15 - last) : last;
+    }
+    step &= 0x1F;
+    u8 up = (shape & 0x04) ? 1:0;
+    if ((shape & 0x02) && (step & 0x10)) up ^= 1;  // Alternate
+    return up ? (step & 0x0F) : (15 - (step & 0x0F));
+}
+
+void ay38910Reset(AY38910 *chip)
+{
+    memset(chip, 0x00, sizeof(AY38910));
+    chip->ayRng = 1;
+    chip->ayRegs[7] = 0xFF;
+}
+
+int  ay38910GetStateSize(void) {return sizeof(AY38910);}
+int  ay38910SaveState(void *dest, const AY38910 *chip) {memcpy(dest, chip, sizeof(AY38910)); return sizeof(AY38910);}
+int  ay38910LoadState(AY38910 *chip, const void *source) {memcpy(chip, source, sizeof(AY38910)); return sizeof(AY38910);}
+
+void ay38910IndexW(u8 index, AY38910 *chip)
+{
+    chip->ayRegIndex = index;
+}
+
+void ay38910DataW(u8 value, AY38910 *chip)
+{
+    static const u8 reg_mask[16] = {0xFF,0x0F,0xFF,0x0F,0xFF,0x0F,0x1F,0xFF,0x1F,0x1F,0x1F,0xFF,0xFF,0x0F,0xFF,0xFF};
+    u8 index = chip->ayRegIndex & 0x0F;
+    if (chip->ayRegIndex & 0xF0) return;
+
+    chip->ayRegs[index] = value & reg_mask[index];
+    if (index == 13) {chip->ayEnvAddr = 0; chip->ayEnvFreq = 0;}   // Writing the shape restarts the envelope
+}
+
+u8 ay38910DataR(AY38910 *chip)
+{
+    return chip->ayRegs[chip->ayRegIndex & 0x0F];
+}
+
+// Count a divider on by 'step' chip ticks - how many times it wrapped. The odd tick
+// left over when a two tick step passes the period is carried so LOW keeps the pitch,
+// and a period of 1 wraps on both ticks.
+static int ay_count(u32 *counter, u32 period, int step)
+{
+    *counter += step;
+    if (*counter < period) return 0;
+    *counter -= period;
+    if (*counter >= (u32)step) { *counter = 0; return 1; }  // Period made shorter while counting
+    if (*counter < period) return 1;
+    *counter -= period;
+    return 2;
+}
+
+static void ay_mix(int count, s16 *dest, AY38910 *chip, int step)
+{
+    u8 *regs = chip->ayRegs;
+
+    for (int i=0; i<count; i++)
+    {
+        s32 acc = 0;
+        for (int tick=0; tick < (1<<AY_UPSHIFT); tick++)
+        {
+            for (int ch=0; ch<3; ch++)
+            {
+                u16 period = regs[ch*2] | (regs[ch*2+1] << 8);
+                if (period == 0) period = 1;
+                u32 counter = *ay_freq(chip, ch);
+                if (ay_count(&counter, period, step)) *ay_out(chip, ch) ^= 1;
+                *ay_freq(chip, ch) = counter;
+            }
+
+            u16 nperiod = (regs[6] ? regs[6] : 1) << 1;
+            u32 counter = chip->ch3Freq;
+            for (int n = ay_count(&counter, nperiod, step); n > 0; n--)
+            {
+                chip->ayRng = (chip->ayRng >> 1) | (((chip->ayRng ^ (chip->ayRng >> 3)) & 1) << 16);
+                chip->ch3Addr = chip->ayRng & 1;
+            }
+            chip->ch3Freq = counter;
+
+            u32 eperiod = (regs[11] | (regs[12] << 8)); if (eperiod == 0) eperiod = 1;
+            for (int n = ay_count(&chip->ayEnvFreq, eperiod << 1, step); n > 0; n--)
+            {
+                if (++chip->ayEnvAddr >= 48) chip->ayEnvAddr = 16;
+            }
+
+            u8 env = ay_env_volume(chip);
+            for (int ch=0; ch<3; ch++)
+            {
+                u8 tone_off  = (regs[7] >> ch) & 1;
+                u8 noise_off = (regs[7] >> (ch+3)) & 1;
+                if ((tone_off | *ay_out(chip, ch)) & (noise_off | chip->ch3Addr))
+                {
+                    u8 vol = regs[8+ch];
+                    acc += ay_levels[(vol & 0x10) ? env : (vol & 0x0F)];
+                }
+            }
+        }
+        *dest++ = (s16)(acc >> AY_UPSHIFT);
+    }
+}
+
+void ay38910Mixer(int count, s16 *dest, AY38910 *chip)
+{
+    ay_mix(count, dest, chip, 1);
+}
+
+void ay38910MixerLo(int count, s16 *dest, AY38910 *chip)
+{
+    ay_mix(count, dest, chip, 2);
+}
@@ -0,0 +1,144 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+//
+// The host side of the libnds shim - maps the DS VRAM banks at their real
+// addresses and provides the globals and front-end hooks which, on the DS,
+// live in SpeccySE.c and SpeccyUtils.c (which are not part of the host build).
+//
+#include <nds.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#include "SpeccySE.h"
+#include "SpeccyUtils.h"
+#include "cpu/z80/Z80_interface.h"
+
+// ---------------------------------------------------------------------------
+// The core writes the screen to 0x06000000 (or the DSi screen buffers at
+// 0x06010000/0x06020000) and keeps the tape PatchLookup[] at 0x06860000.
+// We map the whole VRAM range so those fixed addresses are real memory.
+// PatchLookup[] holds 8 byte pointers on a 64-bit host so needs 512K.
+// ---------------------------------------------------------------------------
+#define HOST_VRAM_BASE  0x06000000
+#define HOST_VRAM_SIZE  0x00A00000
+
+u8  host_dsi_mode = 1;
+u16 host_bg_palette_sub[256];
+
+u64 host_prof_ns[PROF_SLOTS];
+u64 host_prof_mark[PROF_SLOTS];
+
+u64 host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void host_map_vram(void)
+{
+    void *vram = mmap((void*)HOST_VRAM_BASE, HOST_VRAM_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (vram != (void*)HOST_VRAM_BASE)
+    {
+        fprintf(stderr, "Unable to map the DS VRAM range at 0x%08X\n", HOST_VRAM_BASE);
+        exit(1);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Globals which normally live in SpeccySE.c
+// ---------------------------------------------------------------------------
+u32 debug[0x10]={0};
+u32 DX = 0;
+u32 DY = 0;
+
+u8 RAM_Memory[0x10000]    ALIGN(32) = {0};
+u8 RAM_Memory128[0x20000] ALIGN(32) = {0};
+u8 SpectrumBios[0x4000]             = {0};
+u8 SpectrumBios128[0x8000]          = {0};
+u8 ROM_Memory[MAX_TAPE_SIZE];
+
+char initial_file[MAX_FILENAME_LEN] = "";
+char initial_path[MAX_FILENAME_LEN] = "";
+char last_path[MAX_FILENAME_LEN]    = "";
+char last_file[MAX_FILENAME_LEN]    = "";
+
+u8  bFirstTime        = 3;
+u8  bottom_screen     = 0;
+u8  speccy_mode       = 0;
+u8  kbd_key           = 0;
+u16 nds_key           = 0;
+u8  kbd_keys_pressed  = 0;
+u8  kbd_keys[12];
+u16 emuFps            = 0;
+u16 emuActFrames      = 0;
+u16 timingFrames      = 0;
+
+// ---------------------------------------------------------------------------
+// Globals which normally live in SpeccyUtils.c
+// ---------------------------------------------------------------------------
+struct Config_t       myConfig;
+struct GlobalConfig_t myGlobalConfig;
+u8 *MemoryMap[4]      = {0,0,0,0};
+Z80 CPU;
+u32 file_crc          = 0x00000000;
+AY38910 myAY;
+u16 JoyState          = 0;
+u8 BufferedKeys[32];
+u8 BufferedKeysWriteIdx=0;
+u8 BufferedKeysReadIdx=0;
+
+// ---------------------------------------------------------------------------
+// Front-end hooks the core calls - there is no screen or menu on the host
+// ---------------------------------------------------------------------------
+void DSPrint(int iX,int iY,int iScr,char *szMessage) {}
+void DisplayStatusLine(bool bForce) {}
+void pok_init() {}
+void _putchar(char character) {}
+
+void Trap_Bad_Ops(char *prefix, byte I, word W)
+{
+    fprintf(stderr, "Bad opcode %s %02X at %04X\n", prefix, I, W);
+}
+
+void BufferKey(u8 key)
+{
+    BufferedKeys[BufferedKeysWriteIdx] = key;
+    BufferedKeysWriteIdx = (BufferedKeysWriteIdx+1) % 32;
+}
+
+// Same hold/dampen timing as the DS front-end so auto-typed LOAD "" works
+void ProcessBufferedKeys(void)
+{
+    static u8 next_dampen_time = 10;
+    static u8 dampen = 0;
+    static u8 buf_held = 0;
+
+    if (++dampen >= next_dampen_time)
+    {
+        if (BufferedKeysReadIdx != BufferedKeysWriteIdx)
+        {
+            buf_held = BufferedKeys[BufferedKeysReadIdx];
+            BufferedKeysReadIdx = (BufferedKeysReadIdx+1) % 32;
+            if (buf_held == 255) {buf_held = 0; next_dampen_time=30;}
+            else if (buf_held == 254) {buf_held = 0; next_dampen_time=20;}
+            else next_dampen_time = 10;
+        } else buf_held = 0;
+        dampen = 0;
+    }
+
+    if (buf_held) {kbd_keys[kbd_keys_pressed++] = buf_held;}
+}
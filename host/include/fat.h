@@ -0,0 +1,4 @@
+// Host stand-in for <fat.h> - the host uses the normal C library for file access
+#ifndef _HOST_FAT_H_
+#define _HOST_FAT_H_
+#endif // _HOST_FAT_H_
@@ -0,0 +1,16 @@
+// Host stand-in for <maxmod9.h> - just the stream callback types used by sound.c
+#ifndef _HOST_MAXMOD9_H_
+#define _HOST_MAXMOD9_H_
+
+typedef unsigned int    mm_word;
+typedef void*           mm_addr;
+
+typedef enum
+{
+    MM_STREAM_8BIT_MONO    = 0,
+    MM_STREAM_8BIT_STEREO  = 1,
+    MM_STREAM_16BIT_MONO   = 2,
+    MM_STREAM_16BIT_STEREO = 3
+} mm_stream_formats;
+
+#endif // _HOST_MAXMOD9_H_
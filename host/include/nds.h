@@ -0,0 +1,79 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+//
+// A very thin stand-in for the libnds <nds.h> so that the emulation core
+// (Z80.c, spectrum.c, tapeload.c and sound.c) can be compiled and run
+// headless on a Linux box. Only what the core actually touches is here.
+//
+#ifndef _HOST_NDS_H_
+#define _HOST_NDS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef uint8_t         u8;
+typedef uint16_t        u16;
+typedef uint32_t        u32;
+typedef uint64_t        u64;
+typedef int8_t          s8;
+typedef int16_t         s16;
+typedef int32_t         s32;
+typedef int64_t         s64;
+typedef volatile u8     vu8;
+typedef volatile u16    vu16;
+typedef volatile u32    vu32;
+
+#ifndef TRUE
+#define TRUE            1
+#define FALSE           0
+#endif
+
+// No tightly coupled memory on the host - everything is just normal memory
+#define ITCM_CODE
+#define DTCM_DATA
+#define DTCM_BSS
+#define ALIGN(m)        __attribute__((aligned(m)))
+
+#define RGB15(r,g,b)    ((r)|((g)<<5)|((b)<<10))
+
+// ------------------------------------------------------------------------------
+// The VRAM banks (0x06000000 - 0x069FFFFF) are mapped at their real addresses
+// by host_nds.c so the fixed addresses used by the core (the 0x06000000 screen,
+// the DSi back buffers and the PatchLookup[] table) just work.
+// ------------------------------------------------------------------------------
+extern u16  host_bg_palette_sub[256];
+#define BG_PALETTE_SUB  host_bg_palette_sub
+
+extern u8   host_dsi_mode;
+static inline bool isDSiMode(void) {return host_dsi_mode;}
+
+// There are no interrupts on the host - the bench does the vblank work between frames
+static inline int  enterCriticalSection(void) {return 0;}
+static inline void leaveCriticalSection(int oldIME) {(void)oldIME;}
+
+// ------------------------------------------------------------------------------
+// Timing hooks for the benchmark - the core brackets the renderer and the audio
+// mixer with these so the host can split the frame time between CPU, render and
+// audio. On the DS the hooks are defined away to nothing (see SpeccySE.h).
+// ------------------------------------------------------------------------------
+#define PROF_RENDER     0
+#define PROF_AUDIO      1
+#define PROF_SLOTS      2
+
+extern u64 host_prof_ns[PROF_SLOTS];
+extern u64 host_prof_mark[PROF_SLOTS];
+extern u64 host_now_ns(void);
+
+#define PROFILE_BEGIN(slot) host_prof_mark[slot] = host_now_ns()
+#define PROFILE_END(slot)   host_prof_ns[slot] += host_now_ns() - host_prof_mark[slot]
+
+#endif // _HOST_NDS_H_
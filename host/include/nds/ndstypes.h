@@ -0,0 +1,2 @@
+// Host stand-in for <nds/ndstypes.h> - the types are all in our <nds.h>
+#include "../nds.h"
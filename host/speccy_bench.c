@@ -0,0 +1,331 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+//
+// Headless frame-rate benchmark for the SpeccySE emulation core. Loads a .z80,
+// .sna, .tap or .tzx file, runs N frames of speccy_run() as fast as possible
+// (no 50Hz pacing) and reports emulated frames/sec, effective Z80 MHz and how
+// the time was split between the CPU, the screen renderer and the audio mixer.
+//
+#include <nds.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <maxmod9.h>
+
+#include "SpeccySE.h"
+#include "SpeccyUtils.h"
+#include "render.h"
+#include "cpu/z80/Z80_interface.h"
+
+extern void host_map_vram(void);
+extern u8   host_dsi_mode;
+extern mm_word OurSoundMixer(mm_word len, mm_addr dest, mm_stream_formats format);
+
+static u32 read_file(const char *filename, u8 *buf, u32 buf_size)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) return 0;
+    u32 size = fread(buf, 1, buf_size, fp);
+    fclose(fp);
+    return size;
+}
+
+// --------------------------------------------------------------------------
+// A simple FNV-1a hash of the emulated memory and the Z80 registers. Any
+// core change which is meant to be a pure speed-up must leave this alone.
+// --------------------------------------------------------------------------
+static u32 state_hash(void)
+{
+    u32 hash = 0x811C9DC5;
+    u8 *mem  = zx_128k_mode ? RAM_Memory128 : RAM_Memory + 0x4000;
+    u32 size = zx_128k_mode ? 0x20000 : 0xC000;
+
+    for (u32 i=0; i<size; i++) hash = (hash ^ mem[i]) * 0x01000193;
+    hash = (hash ^ CPU.PC.W) * 0x01000193;
+    hash = (hash ^ CPU.SP.W) * 0x01000193;
+    hash = (hash ^ CPU.AF.W) * 0x01000193;
+    return hash;
+}
+
+// --------------------------------------------------------------------------
+// A built-in 128K program for checking the memory contention when the bank
+// at 0xC000 is switched in the middle of a screen line. Every frame it goes
+// down to screen line 40 or so and then, for 32 lines, writes the bank that
+// is already paged in (bank 1 - contended) back to the port in PAGE_TEST_PORT
+// and reads that bank for the rest of the line. It then counts in HL until
+// the next interrupt and the IM 2 handler stores the count. Run once with the
+// port at 7FFD and once at FFFF (which nothing decodes) - as the banking does
+// not change, the counts must come out the same.
+// --------------------------------------------------------------------------
+#define PAGE_TEST_PORT   0x9000
+#define PAGE_TEST_COUNT  0x9002
+
+static const u8 page_test_code[] =
+{
+    0xF3,                   // 8000 DI
+    0x31,0x00,0xBF,         //      LD SP,BF00
+    0x3E,0x81,              //      LD A,81         ; IM 2 vectors are all 8383 (see below)
+    0xED,0x47,              //      LD I,A
+    0xED,0x5E,              //      IM 2
+    0xFB,                   //      EI
+    0x76,                   //      HALT
+    0x16,0x07,              // 800C LD D,7          ; Down to the screen (7 x 3.3K T-states)
+    0x06,0x00,              //      LD B,0
+    0x10,0xFE,              //      DJNZ $
+    0x15,                   //      DEC D
+    0x20,0xF9,              //      JR NZ,-7
+    0x1E,0x20,              //      LD E,32         ; 32 lines...
+    0xED,0x4B,0x00,0x90,    // 8019 LD BC,(9000)
+    0x3E,0x01,              //      LD A,1
+    0xED,0x79,              //      OUT (C),A       ; ...re-paging bank 1 part way along each
+    0x21,0x00,0xC0,         //      LD HL,C000
+    0x7E,0x7E,0x7E,0x7E,    //      LD A,(HL) x 24  ; and reading contended memory after it
+    0x7E,0x7E,0x7E,0x7E,
+    0x7E,0x7E,0x7E,0x7E,
+    0x7E,0x7E,0x7E,0x7E,
+    0x7E,0x7E,0x7E,0x7E,
+    0x7E,0x7E,0x7E,0x7E,
+    0x1D,                   //      DEC E
+    0xC2,0x19,0x80,         //      JP NZ,8019
+    0x21,0x00,0x00,         //      LD HL,0
+    0x23,                   // 8047 INC HL          ; Count until the interrupt
+    0x18,0xFD,              //      JR 8047
+};
+
+static const u8 page_test_isr[] =
+{
+    0x22,0x02,0x90,         // 8383 LD (9002),HL
+    0xD1,                   //      POP DE          ; Drop the return into the count loop
+    0xFB,                   //      EI
+    0xC3,0x0C,0x80,         //      JP 800C
+};
+
+// Build the program as an uncompressed v3 .z80 snapshot and run it for the given frames
+static u32 page_test_run(u16 port, u32 frames)
+{
+    u8 *z80 = ROM_Memory;
+    u8 *bank2;
+
+    memset(z80, 0x00, 86 + 3 + 0x4000);
+    z80[8]  = 0x00; z80[9] = 0xBF;      // SP
+    z80[29] = 2;                        // IM 2
+    z80[30] = 54;                       // v3 header...
+    z80[32] = 0x00; z80[33] = 0x80;     // PC
+    z80[34] = 4;                        // ZX Spectrum 128K
+    z80[35] = 0x01;                     // Bank 1 at 0xC000
+    z80[86] = 0xFF; z80[87] = 0xFF;     // Bank 2 (page 5) stored uncompressed
+    z80[88] = 5;
+    bank2 = &z80[89];
+    memcpy(bank2, page_test_code, sizeof(page_test_code));
+    memset(bank2 + 0x0100, 0x83, 0x101);
+    memcpy(bank2 + 0x0383, page_test_isr, sizeof(page_test_isr));
+    bank2[0x1000] = port & 0xFF; bank2[0x1001] = port >> 8;
+
+    last_file_size = 86 + 3 + 0x4000;
+    speccy_mode = MODE_Z80;
+    ResetZ80(&CPU);
+    speccy_reset();
+
+    u32 total = 0;
+    for (u32 frame=0; frame < frames; frame++)
+    {
+        while (speccy_run()) ;
+        if (frame >= 2) total += RAM_Memory128[2*0x4000 + 0x1002] | (RAM_Memory128[2*0x4000 + 0x1003] << 8);
+    }
+    return total;
+}
+
+static int page_test(u32 frames)
+{
+    if (frames < 3) frames = 3;
+    u32 paged   = page_test_run(0x7FFD, frames);
+    u32 unpaged = page_test_run(0xFFFF, frames);
+
+    printf("Paging test: %u frames of re-paging 7FFD part way along 32 screen lines\n", frames);
+    printf("  Count loops  : %.1f per frame paging, %.1f per frame not paging\n", (double)paged / (frames-2), (double)unpaged / (frames-2));
+    printf("  Contention   : %s\n", (paged == unpaged) ? "OK" : "MISMATCH");
+    return (paged == unpaged) ? 0:1;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: speccy_bench [options] game.z80|.sna|.tap|.tzx\n");
+    fprintf(stderr, "       speccy_bench [options] -pagetest\n");
+    fprintf(stderr, "  -frames N      number of frames to emulate (default 3000 = 60 seconds of PAL)\n");
+    fprintf(stderr, "  -bios FILE     48K Spectrum ROM (default 48.rom)\n");
+    fprintf(stderr, "  -bios128 FILE  128K Spectrum ROM (default 128.rom)\n");
+    fprintf(stderr, "  -128           load tapes as ZX Spectrum 128K\n");
+    fprintf(stderr, "  -lite          emulate a DS-Lite/Phat (single screen buffer)\n");
+    fprintf(stderr, "  -dsi           emulate a DSi (render every frame - default)\n");
+    fprintf(stderr, "  -double        DSi with two screen buffers instead of three\n");
+    fprintf(stderr, "  -contention N  0=normal, 1=light, 2=heavy\n");
+    fprintf(stderr, "  -noidle        run idle loops instead of skipping ahead\n");
+    fprintf(stderr, "  -frame         render the screen by frame instead of line by line\n");
+    fprintf(stderr, "  -skip N        pin the frameskip at N skipped frames per drawn frame (0-3)\n");
+    fprintf(stderr, "  -kernel N      draw with renderer kernel N (0=ternary, 1=mask) instead of the fastest\n");
+    fprintf(stderr, "  -dma N         1=draw lines into a buffer and copy them to VRAM, 0=draw VRAM directly\n");
+    fprintf(stderr, "  -lowaudio      LOW sound quality - half the samples at half the stream rate\n");
+    fprintf(stderr, "  -instant       INSTANT tape speed - standard blocks go straight in through LD-BYTES\n");
+    fprintf(stderr, "  -pagetest      run the built-in check of contention after a 128K bank switch mid-line\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *game     = NULL;
+    const char *bios48   = "48.rom";
+    const char *bios128  = "128.rom";
+    u32  frames          = 3000;
+    u8   double_buffer   = 0;
+    s8   kernel          = -1;
+    s8   dma             = -1;
+    u8   low_audio       = 0;
+    u8   pagetest        = 0;
+
+    memset(&myConfig, 0x00, sizeof(myConfig));
+    myConfig.autoStop    = 1;
+    myConfig.tapeSpeed   = 1;
+    myConfig.autoLoad    = 1;
+
+    for (int i=1; i<argc; i++)
+    {
+        if      (!strcmp(argv[i], "-frames") && (i+1 < argc))       frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-bios") && (i+1 < argc))         bios48 = argv[++i];
+        else if (!strcmp(argv[i], "-bios128") && (i+1 < argc))      bios128 = argv[++i];
+        else if (!strcmp(argv[i], "-contention") && (i+1 < argc))   myConfig.contention = atoi(argv[++i]) % 3;
+        else if (!strcmp(argv[i], "-noidle"))                       myConfig.idleLoop = 1;
+        else if (!strcmp(argv[i], "-frame"))                        myConfig.renderMode = 1;
+        else if (!strcmp(argv[i], "-kernel") && (i+1 < argc))       kernel = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-dma") && (i+1 < argc))          dma = atoi(argv[++i]) ? 1:0;
+        else if (!strcmp(argv[i], "-skip") && (i+1 < argc))         {myConfig.frameSkipMin = atoi(argv[++i]) & 3; myConfig.frameSkipMax = 3 - myConfig.frameSkipMin;}
+        else if (!strcmp(argv[i], "-128"))                          myConfig.loadAs = 1;
+        else if (!strcmp(argv[i], "-lite"))                         host_dsi_mode = 0;
+        else if (!strcmp(argv[i], "-dsi"))                          host_dsi_mode = 1;
+        else if (!strcmp(argv[i], "-double"))                       double_buffer = 1;
+        else if (!strcmp(argv[i], "-lowaudio"))                     low_audio = 1;
+        else if (!strcmp(argv[i], "-instant"))                      myConfig.tapeSpeed = 2;
+        else if (!strcmp(argv[i], "-pagetest"))                     pagetest = 1;
+        else if (argv[i][0] != '-')                                 game = argv[i];
+        else {usage(); return 1;}
+    }
+
+    if ((game == NULL) && !pagetest) {usage(); return 1;}
+
+    host_map_vram();
+    zx_video_buffers = host_dsi_mode ? (double_buffer ? 2:3) : 1;   // As spectrumInit() sets up the VRAM
+    render_benchmark((u32*)ZX_VIDEO_BUFFER(zx_video_buffers-1));
+    if (kernel >= 0) render_select(kernel);
+    if (dma >= 0) render_dma = dma;
+
+    if (!read_file(bios48, SpectrumBios, 0x4000))     fprintf(stderr, "Warning: no 48K BIOS found at %s\n", bios48);
+    if (!read_file(bios128, SpectrumBios128, 0x8000)) fprintf(stderr, "Warning: no 128K BIOS found at %s\n", bios128);
+
+    if (pagetest) return page_test(frames);
+
+    last_file_size = read_file(game, ROM_Memory, MAX_TAPE_SIZE);
+    if (last_file_size == 0) {fprintf(stderr, "Unable to read %s\n", game); return 1;}
+    strcpy(initial_file, game);
+
+    const char *ext = strrchr(game, '.');
+    if (ext == NULL) ext = "";
+    if      (!strcasecmp(ext, ".z80")) speccy_mode = MODE_Z80;
+    else if (!strcasecmp(ext, ".sna")) speccy_mode = MODE_SNA;
+    else if (!strcasecmp(ext, ".tap")) speccy_mode = MODE_TAP;
+    else if (!strcasecmp(ext, ".tzx")) speccy_mode = MODE_TZX;
+    else {fprintf(stderr, "Unknown file type %s\n", game); return 1;}
+
+    // Same sequence as ResetSpectrum() on the DS
+    sound_set_quality(low_audio);
+    sound_chip_reset();
+    ResetZ80(&CPU);
+    speccy_reset();
+    SoundUnPause();
+
+    // Tapes need the LOAD "" typed in just as the DS front-end does it
+    u8 first_time = 2;
+
+    u64 total_tstates = 0;
+    u64 idle_tstates = 0;
+    s16 sound_buf[1024];
+    double stream_due = 0;
+    u64 start_ns = host_now_ns();
+
+    for (u32 frame=0; frame < frames; frame++)
+    {
+        // One call per scanline - TStates is rewound to 0 at the end of each (non tape) frame
+        u32 more;
+        do
+        {
+            u32 before = CPU.TStates;
+            more = speccy_run();
+            if (CPU.TStates >= before) total_tstates += CPU.TStates - before;
+            else total_tstates += (zx_128k_mode ? 70908:69888) - before + CPU.TStates;
+        } while (more);
+        idle_tstates += zx_idle_last_frame;
+
+        // And the vblank flips to the screen buffer that was just finished
+        if (backgroundRenderScreen) {zx_video_show = backgroundRenderScreen & 0x03; backgroundRenderScreen = 0;}
+
+        // Drain the sound ring the way maxmod would - 264 of its 30800Hz (or 15400Hz at LOW) samples per callback and a frame is 20.01ms
+        stream_due += (30800 >> audio_low) * 0.02001;
+        while (stream_due >= 264) {OurSoundMixer(264, sound_buf, MM_STREAM_16BIT_STEREO); stream_due -= 264;}
+
+        if (first_time && (--first_time == 0) && (speccy_mode < MODE_SNA) && myConfig.autoLoad)
+        {
+            if (zx_128k_mode) BufferKey(KBD_KEY_RET);
+            else {BufferKey('J'); BufferKey(KBD_KEY_SYMBOL); BufferKey('P'); BufferKey(KBD_KEY_SYMBOL); BufferKey('P'); BufferKey(KBD_KEY_RET);}
+        }
+
+        tape_frame();
+
+        kbd_keys_pressed = 0;
+        memset(kbd_keys, 0x00, sizeof(kbd_keys));
+        ProcessBufferedKeys();
+    }
+
+    u64 elapsed_ns = host_now_ns() - start_ns;
+    u64 render_ns  = host_prof_ns[PROF_RENDER];
+    u64 audio_ns   = host_prof_ns[PROF_AUDIO];
+    u64 cpu_ns     = elapsed_ns - render_ns - audio_ns;
+    double secs    = elapsed_ns / 1e9;
+
+    printf("%s: %u frames in %.3f sec (%s, %s)\n", game, frames, secs, zx_128k_mode ? "128K":"48K", host_dsi_mode ? "DSi":"DS-Lite");
+    printf("  Frames/sec   : %.1f (%.1fx real time)\n", frames / secs, (frames / secs) / 50.0);
+    printf("  Z80 MHz      : %.2f (%llu T-states)\n", (total_tstates / secs) / 1e6, (unsigned long long)total_tstates);
+    printf("  CPU          : %6.2f%%  %8.3f us/frame\n", 100.0 * cpu_ns / elapsed_ns,    cpu_ns / 1e3 / frames);
+    printf("  Render       : %6.2f%%  %8.3f us/frame\n", 100.0 * render_ns / elapsed_ns, render_ns / 1e3 / frames);
+    printf("  Audio        : %6.2f%%  %8.3f us/frame\n", 100.0 * audio_ns / elapsed_ns,  audio_ns / 1e3 / frames);
+    printf("  Idle skipped : %.2f%% (%llu T-states)\n", total_tstates ? (100.0 * idle_tstates / total_tstates):0.0, (unsigned long long)idle_tstates);
+    printf("  Tape         : %s\n", tape_is_playing() ? "still playing" : "stopped");
+    printf("  Sound ring   : %u under, %u over, %u avg fill, read rate %+.2f%%\n", mixer_underruns, mixer_overruns, mixer_fill_avg >> 8, 100.0 * ((double)mixer_ratio / 65536.0 - 1.0));
+    printf("  State hash   : %08X (PC=%04X)\n", state_hash(), CPU.PC.W);
+    for (u8 k=0; k<RENDER_KERNELS; k++)
+    {
+        if (render_kernels[k] == NULL) continue;
+        printf("  Kernel       : %-8s %6u ns/line%s%s\n", render_kernel_names[k], render_bench_ns[k], render_bench_ok[k] ? "":" (MISMATCH)", (((k == render_kernel) && !render_dma) ? " *":""));
+    }
+    printf("  Line DMA     : %-8s %6u ns/line%s\n", "FASTEST", render_bench_dma_ns, render_dma ? " *":"");
+
+#ifdef Z80_PROFILE
+    static const char *page_names[Z80_PROF_PAGES] = {"", "CB", "ED", "DD", "FD", "DDCB", "FDCB"};
+    u16 top[10];
+    int found = TopProfileZ80(Z80_ProfPC, 256, 10, top);
+    printf("  Top PC       :");
+    for (int i=0; i<found; i++) printf(" %02X00(%u)", top[i], Z80_ProfPC[top[i]]);
+    found = TopProfileZ80(&Z80_ProfOps[0][0], Z80_PROF_PAGES*256, 10, top);
+    printf("\n  Top opcodes  :");
+    for (int i=0; i<found; i++) printf(" %s%02X(%u)", page_names[top[i]>>8], top[i]&0xFF, Z80_ProfOps[top[i]>>8][top[i]&0xFF]);
+    printf("\n");
+#endif
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+// =====================================================================================
+// Copyright (c) 2025 Dave Bernazzani (wavemotion-dave)
+//
+// Copying and distribution of this emulator, its source code and associated
+// readme files, with or without modification, are permitted in any medium without
+// royalty provided this copyright notice is used and wavemotion-dave and Marat
+// Fayzullin (Z80 core) are thanked profusely.
+//
+// The SpeccySE emulator is offered as-is, without any warranty. Please see readme.md
+// =====================================================================================
+//
+// ZEXDOC/ZEXALL conformance harness for the Z80 core. Runs the CP/M test program
+// with 64K of flat RAM and a tiny BDOS (console output only) reached through CALL 5,
+// then reports pass/fail for every test group along with the speed the core achieved.
+// With -quick only the cheaper test groups are run so it can be used as a regression
+// gate after every change to Codes*.h - the full run takes a few minutes.
+//
+#include <nds.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cpu/z80/Z80_interface.h"
+
+extern void host_map_vram(void);
+extern u8 *MemoryMap[4];
+
+// ---------------------------------------------------------------------------
+// The core expects these from spectrum.c - CP/M has no ULA so nothing is
+// ever contended, there are no idle loops to skip and no screen to track.
+// ---------------------------------------------------------------------------
+u8  zx_contend_table[4]  = {0,0,0,0};
+u8  zx_ula_contend[256]  = {0};
+u32 zx_contend_base      = 0;
+u32 zx_idle_skipped      = 0;
+u8  zx_screen_slot[4]    = {0,0,0,0};
+u8  zx_dirty_rows[192]   ALIGN(4);
+u8  zx_beam_render       = 0;
+
+u8 zx_idle_loop(word start, word jr) {return 0;}
+void zx_beam_log_write(u32 tstates, word offset, u8 value) {}
+
+// ---------------------------------------------------------------------------
+// The CP/M machine. The BDOS entry at 0005 jumps to a stub at FE00 which does
+// an OUT (0),A - that lands in cpu_writeport_speccy() below where we look at C
+// for the function number. A warm boot (JP 0000) does an OUT (1),A to flag the
+// end of the run and then sits on a HALT. The word at 0006 is also the top of
+// the TPA which is where ZEXDOC puts its stack.
+// ---------------------------------------------------------------------------
+#define BDOS_STUB       0xFE00
+#define PORT_BDOS       0x00
+#define PORT_BOOT       0x01
+
+#define CHUNK_TSTATES   1000000
+
+static u8  cpm_ram[0x10000] ALIGN(32);
+static u8  cpm_done = 0;
+static u32 cpm_done_tstates = 0;
+
+static char line_buf[256];
+static u32  line_len = 0;
+
+static u32 groups_run = 0;
+static u32 groups_ok = 0;
+static u32 groups_failed = 0;
+
+static u64 total_tstates = 0;
+static u64 total_instr = 0;
+static u64 group_instr = 0;
+static u64 group_ns = 0;
+
+// ---------------------------------------------------------------------------
+// Every result line ends in OK or has ERROR in it - print it with the cost of
+// that group alongside. Anything else (the banner) is passed through as-is.
+// ---------------------------------------------------------------------------
+static void console_line(void)
+{
+    line_buf[line_len] = 0;
+
+    u8 ok  = (line_len >= 2) && !strcmp(&line_buf[line_len-2], "OK");
+    u8 err = (strstr(line_buf, "ERROR") != NULL);
+
+    if (ok || err)
+    {
+        u64 now = host_now_ns();
+        double secs = (now - group_ns) / 1e9;
+        groups_run++;
+        if (err) groups_failed++; else groups_ok++;
+        printf("%-60s %7.1fM instr %6.2f sec\n", line_buf, (total_instr - group_instr) / 1e6, secs);
+        group_instr = total_instr;
+        group_ns = now;
+    }
+    else if (line_len) printf("%s\n", line_buf);
+    fflush(stdout);
+    line_len = 0;
+}
+
+// The line endings are CR LF or LF CR depending on the message - only the LF counts
+static void console_out(char c)
+{
+    if (c == '\n') console_line();
+    else if ((c != '\r') && (line_len < sizeof(line_buf)-1)) line_buf[line_len++] = c;
+}
+
+void cpu_writeport_speccy(register unsigned short Port, register unsigned char Value)
+{
+    if ((Port & 0xFF) == PORT_BOOT) {cpm_done = 1; cpm_done_tstates = CPU.TStates; return;}
+    if ((Port & 0xFF) != PORT_BDOS) return;
+
+    switch (CPU.BC.B.l)
+    {
+        case 2: // Console output of E
+            console_out(CPU.DE.B.l);
+            break;
+        case 9: // Console output of the '$' terminated string at DE
+            for (word addr = CPU.DE.W; cpm_ram[addr] != '$'; addr++) console_out(cpm_ram[addr]);
+            break;
+        default:
+            fprintf(stderr, "Unsupported BDOS call %d at %04X\n", CPU.BC.B.l, CPU.PC.W);
+            cpm_done = 1;
+            break;
+    }
+}
+
+unsigned char cpu_readport_speccy(register unsigned short Port)
+{
+    return 0xFF;
+}
+
+// ---------------------------------------------------------------------------
+// Find the test table. Both ZEXDOC and ZEXALL start with:
+//     start: ld hl,(6) / ld sp,hl / ld de,msg1 / ld c,9 / call bdos / ld hl,tests
+// ---------------------------------------------------------------------------
+static word find_tests(void)
+{
+    static const s16 pattern[] = {0x2A,0x06,0x00,0xF9,0x11,-1,-1,0x0E,0x09,0xCD,-1,-1,0x21};
+    const u32 plen = sizeof(pattern)/sizeof(pattern[0]);
+
+    for (u32 addr=0x100; addr < 0x180; addr++)
+    {
+        u32 i;
+        for (i=0; i<plen; i++)
+        {
+            if ((pattern[i] >= 0) && (cpm_ram[addr+i] != pattern[i])) break;
+        }
+        if (i == plen) return cpm_ram[addr+plen] | (cpm_ram[addr+plen+1] << 8);
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Each test descriptor is a flag mask byte followed by the 20 byte base,
+// increment and shift vectors, the 4 byte expected CRC and the '$' terminated
+// name. The test runs once for every combination of the increment bits and
+// then once more for every single shift bit.
+// ---------------------------------------------------------------------------
+#define DESC_INC        21
+#define DESC_SHIFT      41
+#define DESC_NAME       65
+#define DESC_NAME_MAX   40
+
+// The name must be there and printable or this is not the layout we expect
+static u8 test_name(word desc, char *name)
+{
+    for (u32 i=0; i<DESC_NAME_MAX; i++)
+    {
+        u8 c = cpm_ram[(word)(desc + DESC_NAME + i)];
+        if (c == '$') {name[i] = 0; return (i > 0);}
+        if ((c < 0x20) || (c > 0x7E)) return 0;
+        name[i] = c;
+    }
+    return 0;
+}
+
+static u64 test_iterations(word desc)
+{
+    u32 inc_bits = 0, shift_bits = 0;
+    for (u32 i=0; i<20; i++)
+    {
+        inc_bits   += __builtin_popcount(cpm_ram[(word)(desc + DESC_INC + i)]);
+        shift_bits += __builtin_popcount(cpm_ram[(word)(desc + DESC_SHIFT + i)]);
+    }
+    return (1ULL << inc_bits) * (shift_bits + 1);
+}
+
+// ---------------------------------------------------------------------------
+// Count the groups in the table, checking every descriptor has a name where
+// we expect it. Returns 0 if the table doesn't look like ZEXDOC/ZEXALL.
+// ---------------------------------------------------------------------------
+static u32 count_tests(word tests)
+{
+    char name[DESC_NAME_MAX];
+    u32 total = 0;
+
+    for (word src = tests; total < 256; src += 2)
+    {
+        word desc = cpm_ram[src] | (cpm_ram[(word)(src+1)] << 8);
+        if (desc == 0) return total;
+        if (!test_name(desc, name)) return 0;
+        total++;
+    }
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Drop the expensive test groups from the table so a quick run only takes a
+// few seconds. The ones dropped are listed. Returns the number of groups left.
+// ---------------------------------------------------------------------------
+static u32 trim_tests(word tests, u64 max_iterations)
+{
+    char name[DESC_NAME_MAX];
+    word src = tests, dst = tests;
+    u32 kept = 0;
+
+    for (;;)
+    {
+        word desc = cpm_ram[src] | (cpm_ram[src+1] << 8);
+        if (desc == 0) break;
+        u64 iterations = test_iterations(desc);
+        if (iterations <= max_iterations)
+        {
+            cpm_ram[dst] = desc & 0xFF; cpm_ram[dst+1] = desc >> 8;
+            dst += 2; kept++;
+        }
+        else
+        {
+            test_name(desc, name);
+            printf("  Skipped      : %-30s %llu iterations\n", name, (unsigned long long)iterations);
+        }
+        src += 2;
+    }
+    cpm_ram[dst] = 0; cpm_ram[dst+1] = 0;
+    return kept;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: zex_test [options] zexdoc.com|zexall.com\n");
+    fprintf(stderr, "  -quick         only run the cheaper test groups (regression gate)\n");
+    fprintf(stderr, "  -max N         with -quick, the most iterations a group may have (default 65536)\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *program = NULL;
+    u8  quick = 0;
+    u64 max_iterations = 65536;
+
+    for (int i=1; i<argc; i++)
+    {
+        if      (!strcmp(argv[i], "-quick"))                quick = 1;
+        else if (!strcmp(argv[i], "-max") && (i+1 < argc))  max_iterations = strtoull(argv[++i], NULL, 0);
+        else if (argv[i][0] != '-')                         program = argv[i];
+        else {usage(); return 1;}
+    }
+
+    if (program == NULL) {usage(); return 1;}
+
+    host_map_vram();
+
+    FILE *fp = fopen(program, "rb");
+    if (fp == NULL) {fprintf(stderr, "Unable to read %s\n", program); return 1;}
+    u32 size = fread(&cpm_ram[0x100], 1, BDOS_STUB - 0x100, fp);
+    fclose(fp);
+    if (size == 0) {fprintf(stderr, "Unable to read %s\n", program); return 1;}
+
+    cpm_ram[0x0000] = 0xD3; cpm_ram[0x0001] = PORT_BOOT;                            // OUT (1),A
+    cpm_ram[0x0002] = 0x76;                                                         // HALT
+    cpm_ram[0x0005] = 0xC3; cpm_ram[0x0006] = BDOS_STUB & 0xFF; cpm_ram[0x0007] = BDOS_STUB >> 8; // JP BDOS
+    cpm_ram[BDOS_STUB+0] = 0xD3; cpm_ram[BDOS_STUB+1] = PORT_BDOS;                  // OUT (0),A
+    cpm_ram[BDOS_STUB+2] = 0xC9;                                                    // RET
+
+    // Every group prints exactly one OK or ERROR line - so we know how many to expect
+    word tests = find_tests();
+    u32 expected = tests ? count_tests(tests) : 0;
+    if (quick)
+    {
+        if (expected == 0) {fprintf(stderr, "Unable to find a ZEXDOC/ZEXALL test table in %s\n", program); return 1;}
+        u32 total = expected;
+        expected = trim_tests(tests, max_iterations);
+        printf("Quick run: %u of %u test groups (at most %llu iterations each)\n", expected, total, (unsigned long long)max_iterations);
+    }
+
+    ResetZ80(&CPU);
+    for (int i=0; i<4; i++) MemoryMap[i] = cpm_ram + (i * 0x4000);
+    CPU.PC.W = 0x100;
+    CPU.SP.W = BDOS_STUB;
+
+    u64 start_ns = host_now_ns();
+    group_ns = start_ns;
+
+    while (!cpm_done)
+    {
+        u32 r = CPU.R;
+        ExecZ80_Speccy(CHUNK_TSTATES);
+        total_instr += (u32)(CPU.R - r);        // R counts every M1 cycle (prefixes included)
+        total_tstates += cpm_done ? cpm_done_tstates : CPU.TStates;   // Not the HALT skip at the end
+        CPU.TStates = 0;
+    }
+    if (line_len) console_line();
+
+    double secs = (host_now_ns() - start_ns) / 1e9;
+    if (secs <= 0.0) secs = 1e-9;
+
+    printf("\n");
+    printf("  Groups       : %u run, %u passed, %u failed", groups_run, groups_ok, groups_failed);
+    if (expected) printf(" (%u in the test table)", expected);
+    printf("\n");
+    printf("  Time         : %.2f sec\n", secs);
+    printf("  Instructions : %.1fM (%.2fM/sec, counted as M1 cycles)\n", total_instr / 1e6, total_instr / secs / 1e6);
+    printf("  Z80 MHz      : %.2f (%llu T-states)\n", total_tstates / secs / 1e6, (unsigned long long)total_tstates);
+
+    if (expected && (groups_run != expected)) return 1;
+    return ((groups_failed == 0) && (groups_run > 0)) ? 0 : 1;
+}